@@ -106,6 +106,39 @@ extern "C" {
 #endif
 #endif
 
+/**
+ * Storage of device dependent error information
+ * 0 = malloc/free or ring heap (SCPI_InitHeap) by USE_MEMORY_ALLOCATION_FREE
+ * 1 = Fixed slot pool in the context, O(1) allocation and free
+ *
+ * SCPI_ERROR_INFO_POOL_SIZE is number of slots (max 255), one more than error
+ * queue length is enough. It sizes scpi_t, so override it only globally
+ * (-D for library and application), never in one translation unit. Errors
+ * queued when all slots are taken are stored without information.
+ * SCPI_ERROR_INFO_POOL_SLOT_LENGTH is maximal length of stored information
+ * including terminating '\0', longer text is truncated.
+ */
+#if USE_DEVICE_DEPENDENT_ERROR_INFORMATION
+#ifndef USE_ERROR_INFO_POOL
+#define USE_ERROR_INFO_POOL 1
+#endif
+#else
+#undef USE_ERROR_INFO_POOL
+#define USE_ERROR_INFO_POOL 0
+#endif
+
+#ifndef SCPI_ERROR_INFO_POOL_SIZE
+#define SCPI_ERROR_INFO_POOL_SIZE 18
+#endif
+
+#ifndef SCPI_ERROR_INFO_POOL_SLOT_LENGTH
+#if SYSTEM_TYPE == SYSTEM_FULL_BLOWN
+#define SCPI_ERROR_INFO_POOL_SLOT_LENGTH 64
+#else
+#define SCPI_ERROR_INFO_POOL_SLOT_LENGTH 32
+#endif
+#endif
+
 #ifndef USE_COMMAND_TAGS
 #define USE_COMMAND_TAGS 1
 #endif
@@ -174,6 +207,142 @@ extern "C" {
 #define USE_UNITS_ELECTRIC_CHARGE_CONDUCTANCE SYSTEM_TYPE
 #endif
 
+/**
+ * Build hash index of units table in SCPI_Init for constant time suffix lookup
+ * 0 = Linear search in units table
+ * 1 = Use hash index
+ *
+ * SCPI_UNITS_INDEX_SIZE is number of hash slots (power of two, max 256).
+ * Units table with more than half of SCPI_UNITS_INDEX_SIZE entries is not
+ * indexed and linear search is used instead.
+ */
+#ifndef USE_UNITS_INDEX
+#define USE_UNITS_INDEX 1
+#endif
+
+#ifndef SCPI_UNITS_INDEX_SIZE
+#if SYSTEM_TYPE == SYSTEM_FULL_BLOWN
+#define SCPI_UNITS_INDEX_SIZE 256
+#else
+#define SCPI_UNITS_INDEX_SIZE 64
+#endif
+#endif
+
+/**
+ * Program header is upper-cased into a stack buffer of this size before
+ * command lookup, so pattern compares need no case folding. Input buffer
+ * is never modified. Longer headers are matched with case folding.
+ */
+#ifndef SCPI_HEADER_FOLD_LENGTH
+#if SYSTEM_TYPE == SYSTEM_FULL_BLOWN
+#define SCPI_HEADER_FOLD_LENGTH 64
+#else
+#define SCPI_HEADER_FOLD_LENGTH 32
+#endif
+#endif
+
+/**
+ * Hash index of choice lists (SCPI_ParamChoice, SCPI_ParamBool, special numbers)
+ * 0 = Linear search in choice list
+ * 1 = Use hash index if the choice list has one registered in context
+ *
+ * SCPI_CHOICE_INDEX_SIZE is number of hash slots (power of two, max 256).
+ * Choice list with more than half of SCPI_CHOICE_INDEX_SIZE names (long and
+ * short forms) is not indexed.
+ * SCPI_CHOICE_INDEX_COUNT is number of indexes registrable in one context,
+ * including the two built-in ones for BOOL and special numbers.
+ */
+#ifndef USE_CHOICE_INDEX
+#define USE_CHOICE_INDEX 1
+#endif
+
+#ifndef SCPI_CHOICE_INDEX_SIZE
+#if SYSTEM_TYPE == SYSTEM_FULL_BLOWN
+#define SCPI_CHOICE_INDEX_SIZE 64
+#else
+#define SCPI_CHOICE_INDEX_SIZE 32
+#endif
+#endif
+
+#ifndef SCPI_CHOICE_INDEX_COUNT
+#if SYSTEM_TYPE == SYSTEM_FULL_BLOWN
+#define SCPI_CHOICE_INDEX_COUNT 8
+#else
+#define SCPI_CHOICE_INDEX_COUNT 4
+#endif
+#endif
+
+/**
+ * Maximal number of errors reported by one SYSTem:ERRor:ALL? response.
+ * Remaining errors stay in the queue for next query.
+ */
+#ifndef SCPI_SYSTEM_ERROR_ALL_MAX
+#if SYSTEM_TYPE == SYSTEM_FULL_BLOWN
+#define SCPI_SYSTEM_ERROR_ALL_MAX 32
+#else
+#define SCPI_SYSTEM_ERROR_ALL_MAX 8
+#endif
+#endif
+
+/**
+ * Error queue for producers outside the parser thread (interrupts, driver
+ * threads) filled by SCPI_ErrorPushFromISR.
+ * 0 = Not available
+ * 1 = Lock-free single producer single consumer ring of error codes
+ *
+ * SCPI_ERROR_ISR_QUEUE_SIZE is number of ring entries (power of two).
+ */
+#ifndef USE_ERROR_ISR_QUEUE
+#define USE_ERROR_ISR_QUEUE 1
+#endif
+
+#ifndef SCPI_ERROR_ISR_QUEUE_SIZE
+#if SYSTEM_TYPE == SYSTEM_FULL_BLOWN
+#define SCPI_ERROR_ISR_QUEUE_SIZE 16
+#else
+#define SCPI_ERROR_ISR_QUEUE_SIZE 8
+#endif
+#endif
+
+/**
+ * Size in bytes of stack buffer used to byte swap binary array results
+ * (SCPI_ResultArray* with non-native format) and to format ASCII array
+ * results. Data are written in chunks of this size. Must be multiple of 8
+ * and at least 40.
+ */
+#ifndef SCPI_RESULT_ARRAY_STAGING_LENGTH
+#if SYSTEM_TYPE == SYSTEM_FULL_BLOWN
+#define SCPI_RESULT_ARRAY_STAGING_LENGTH 1024
+#else
+#define SCPI_RESULT_ARRAY_STAGING_LENGTH 64
+#endif
+#endif
+
+/**
+ * Format large ASCII array results (SCPI_ResultArray* with SCPI_FORMAT_ASCII)
+ * by POSIX threads. Array is split into chunks formatted to their own heap
+ * buffers, which are written in order. Needs pthread and malloc.
+ */
+#ifndef USE_PARALLEL_ARRAY_FORMAT
+#define USE_PARALLEL_ARRAY_FORMAT 0
+#endif
+
+/**
+ * Minimal number of elements of one chunk of parallel ASCII array result.
+ * Smaller arrays are formatted serially.
+ */
+#ifndef SCPI_PARALLEL_ARRAY_FORMAT_CHUNK
+#define SCPI_PARALLEL_ARRAY_FORMAT_CHUNK 1024
+#endif
+
+/**
+ * Maximal number of chunks of parallel ASCII array result. First chunk is
+ * formatted by calling thread, others by worker threads.
+ */
+#ifndef SCPI_PARALLEL_ARRAY_FORMAT_THREADS
+#define SCPI_PARALLEL_ARRAY_FORMAT_THREADS 4
+#endif
+
 /* define local macros depending on existance of strnlen */
 #if HAVE_STRNLEN
 #define SCPIDEFINE_strnlen(s, l)	strnlen((s), (l))
@@ -212,26 +381,30 @@ extern "C" {
 
 #if USE_DEVICE_DEPENDENT_ERROR_INFORMATION
 
-  #if USE_MEMORY_ALLOCATION_FREE
+  #if USE_ERROR_INFO_POOL
+    #define SCPIDEFINE_DESCRIPTION_MAX_PARTS            2
+    #define SCPIDEFINE_strndup(c, s, l)                 scpipool_strndup(&(c)->error_info_pool, (s), (l))
+    #define SCPIDEFINE_free(c, s, r)                    scpipool_free(&(c)->error_info_pool, (s))
+  #elif USE_MEMORY_ALLOCATION_FREE
     #include <stdlib.h>
     #include <string.h>
     #define SCPIDEFINE_DESCRIPTION_MAX_PARTS            2
     #if HAVE_STRNDUP
-      #define SCPIDEFINE_strndup(h, s, l)               strndup((s), (l))
+      #define SCPIDEFINE_strndup(c, s, l)               strndup((s), (l))
     #else
-      #define SCPIDEFINE_strndup(h, s, l)               OUR_strndup((s), (l))
+      #define SCPIDEFINE_strndup(c, s, l)               OUR_strndup((s), (l))
     #endif
-    #define SCPIDEFINE_free(h, s, r)                    free((s))
+    #define SCPIDEFINE_free(c, s, r)                    free((s))
   #else
     #define SCPIDEFINE_DESCRIPTION_MAX_PARTS            3
-    #define SCPIDEFINE_strndup(h, s, l)                 scpiheap_strndup((h), (s), (l))
-    #define SCPIDEFINE_free(h, s, r)                    scpiheap_free((h), (s), (r))
-    #define SCPIDEFINE_get_parts(h, s, l1, s2, l2)      scpiheap_get_parts((h), (s), (l1), (s2), (l2))
+    #define SCPIDEFINE_strndup(c, s, l)                 scpiheap_strndup(&(c)->error_info_heap, (s), (l))
+    #define SCPIDEFINE_free(c, s, r)                    scpiheap_free(&(c)->error_info_heap, (s), (r))
+    #define SCPIDEFINE_get_parts(c, s, l1, s2, l2)      scpiheap_get_parts(&(c)->error_info_heap, (s), (l1), (s2), (l2))
   #endif
 #else
   #define SCPIDEFINE_DESCRIPTION_MAX_PARTS              1
-  #define SCPIDEFINE_strndup(h, s, l)                   NULL
-  #define SCPIDEFINE_free(h, s, r)
+  #define SCPIDEFINE_strndup(c, s, l)                   NULL
+  #define SCPIDEFINE_free(c, s, r)
 #endif
 
 #if HAVE_SIGNBIT
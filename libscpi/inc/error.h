@@ -51,6 +51,8 @@ extern "C" {
     void SCPI_ErrorPushEx(scpi_t * context, int16_t err, char * info, size_t info_len);
     void SCPI_ErrorPush(scpi_t * context, int16_t err);
     int32_t SCPI_ErrorCount(scpi_t * context);
+    scpi_bool_t SCPI_ErrorPushFromISR(scpi_t * context, int16_t err);
+    void SCPI_ErrorFlushISR(scpi_t * context);
     const char * SCPI_ErrorTranslate(int16_t err);
 
 
@@ -114,8 +116,8 @@ extern "C" {
     XE(SCPI_ERROR_ARM_DEADLOCK,                 -215, "Arm deadlock")                                 \
     XE(SCPI_ERROR_PARAMETER_ERROR,              -220, "Parameter error")                              \
     XE(SCPI_ERROR_SETTINGS_CONFLICT,            -221, "Settings conflict")                            \
-    XE(SCPI_ERROR_DATA_OUT_OF_RANGE,            -222, "Data out of range")                            \
-    XE(SCPI_ERROR_TOO_MUCH_DATA,                -223, "Too much data")                                \
+    X(SCPI_ERROR_DATA_OUT_OF_RANGE,             -222, "Data out of range")                            \
+    X(SCPI_ERROR_TOO_MUCH_DATA,                 -223, "Too much data")                                \
     X(SCPI_ERROR_ILLEGAL_PARAMETER_VALUE,       -224, "Illegal parameter value")                      \
     XE(SCPI_ERROR_OUT_OF_MEMORY_FOR_REQ_OP,     -225, "Out of memory")                                \
     XE(SCPI_ERROR_LISTS_NOT_SAME_LENGTH,        -226, "Lists not same length")                        \
@@ -50,11 +50,49 @@ extern "C" {
     };
     typedef enum _scpi_expr_result_t scpi_expr_result_t;
 
+    struct _scpi_expr_list_t {
+        lex_state_t lex;
+        int index;
+    };
+    typedef struct _scpi_expr_list_t scpi_expr_list_t;
+
+    struct _scpi_expr_range_t {
+        int32_t from;
+        int32_t to;
+    };
+    typedef struct _scpi_expr_range_t scpi_expr_range_t;
+
+    struct _scpi_expr_range_set_t {
+        scpi_expr_range_t * ranges;
+        size_t capacity;
+        size_t count;
+    };
+    typedef struct _scpi_expr_range_set_t scpi_expr_range_set_t;
+
     scpi_expr_result_t SCPI_ExprNumericListEntry(scpi_t * context, scpi_parameter_t * param, int index, scpi_bool_t * isRange, scpi_parameter_t * valueFrom, scpi_parameter_t * valueTo);
     scpi_expr_result_t SCPI_ExprNumericListEntryInt(scpi_t * context, scpi_parameter_t * param, int index, scpi_bool_t * isRange, int32_t * valueFrom, int32_t * valueTo);
     scpi_expr_result_t SCPI_ExprNumericListEntryDouble(scpi_t * context, scpi_parameter_t * param, int index, scpi_bool_t * isRange, double * valueFrom, double * valueTo);
     scpi_expr_result_t SCPI_ExprChannelListEntry(scpi_t * context, scpi_parameter_t * param, int index, scpi_bool_t * isRange, int32_t * valuesFrom, int32_t * valuesTo, size_t length, size_t * dimensions);
 
+    scpi_expr_result_t SCPI_ExprNumericListBegin(scpi_t * context, scpi_parameter_t * param, scpi_expr_list_t * list);
+    scpi_expr_result_t SCPI_ExprNumericListNext(scpi_t * context, scpi_expr_list_t * list, scpi_bool_t * isRange, scpi_parameter_t * valueFrom, scpi_parameter_t * valueTo);
+    scpi_expr_result_t SCPI_ExprNumericListNextInt(scpi_t * context, scpi_expr_list_t * list, scpi_bool_t * isRange, int32_t * valueFrom, int32_t * valueTo);
+    scpi_expr_result_t SCPI_ExprNumericListNextDouble(scpi_t * context, scpi_expr_list_t * list, scpi_bool_t * isRange, double * valueFrom, double * valueTo);
+    scpi_expr_result_t SCPI_ExprNumericListToArrayInt(scpi_t * context, scpi_parameter_t * param, int32_t * data, size_t i_count, size_t * o_count);
+    scpi_expr_result_t SCPI_ExprChannelListBegin(scpi_t * context, scpi_parameter_t * param, scpi_expr_list_t * list);
+    scpi_expr_result_t SCPI_ExprChannelListNext(scpi_t * context, scpi_expr_list_t * list, scpi_bool_t * isRange, int32_t * valuesFrom, int32_t * valuesTo, size_t length, size_t * dimensions);
+    scpi_expr_result_t SCPI_ExprChannelListToArray(scpi_t * context, scpi_parameter_t * param, int32_t * data, size_t i_count, size_t * o_count);
+
+    void SCPI_ExprRangeSetInit(scpi_expr_range_set_t * set, scpi_expr_range_t * ranges, size_t capacity);
+    scpi_bool_t SCPI_ExprRangeSetAdd(scpi_expr_range_set_t * set, int32_t from, int32_t to);
+    scpi_bool_t SCPI_ExprRangeSetContains(const scpi_expr_range_set_t * set, int32_t value);
+    uint64_t SCPI_ExprRangeSetCount(const scpi_expr_range_set_t * set);
+    scpi_bool_t SCPI_ExprRangeSetFirst(const scpi_expr_range_set_t * set, int32_t * value);
+    scpi_bool_t SCPI_ExprRangeSetNext(const scpi_expr_range_set_t * set, int32_t * value);
+    scpi_bool_t SCPI_ExprRangeSetToBitmap(const scpi_expr_range_set_t * set, int32_t offset, uint8_t * bitmap, size_t bits);
+    scpi_expr_result_t SCPI_ExprNumericListToRangeSet(scpi_t * context, scpi_parameter_t * param, scpi_expr_range_set_t * set);
+    scpi_expr_result_t SCPI_ExprChannelListToRangeSet(scpi_t * context, scpi_parameter_t * param, scpi_expr_range_set_t * set);
+
 #ifdef __cplusplus
 }
 #endif
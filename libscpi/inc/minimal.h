@@ -49,7 +49,9 @@ extern "C" {
 
     scpi_result_t SCPI_SystemVersionQ(scpi_t * context);
     scpi_result_t SCPI_SystemErrorNextQ(scpi_t * context);
+    scpi_result_t SCPI_SystemErrorAllQ(scpi_t * context);
     scpi_result_t SCPI_SystemErrorCountQ(scpi_t * context);
+    scpi_result_t SCPI_SystemErrorStatusQ(scpi_t * context);
     scpi_result_t SCPI_StatusQuestionableEventQ(scpi_t * context);
     scpi_result_t SCPI_StatusQuestionableConditionQ(scpi_t * context);
     scpi_result_t SCPI_StatusQuestionableEnableQ(scpi_t * context);
@@ -51,7 +51,7 @@ extern "C" {
             const char * idn1, const char * idn2, const char * idn3, const char * idn4,
             char * input_buffer, size_t input_buffer_length,
             scpi_error_t * error_queue_data, int16_t error_queue_size);
-#if USE_DEVICE_DEPENDENT_ERROR_INFORMATION && !USE_MEMORY_ALLOCATION_FREE
+#if USE_DEVICE_DEPENDENT_ERROR_INFORMATION && !USE_ERROR_INFO_POOL && !USE_MEMORY_ALLOCATION_FREE
     void SCPI_InitHeap(scpi_t * context, char * error_info_heap, size_t error_info_heap_length);
 #endif
 
@@ -104,6 +104,12 @@ extern "C" {
     scpi_bool_t SCPI_ParamToDouble(scpi_t * context, scpi_parameter_t * parameter, double * value);
     scpi_bool_t SCPI_ParamToChoice(scpi_t * context, scpi_parameter_t * parameter, const scpi_choice_def_t * options, int32_t * value);
     scpi_bool_t SCPI_ChoiceToName(const scpi_choice_def_t * options, int32_t tag, const char ** text);
+#if USE_CHOICE_INDEX
+    scpi_bool_t SCPI_ChoiceIndexInit(scpi_choice_index_t * index, const scpi_choice_def_t * options);
+    scpi_bool_t SCPI_ChoiceIndexRegister(scpi_t * context, const scpi_choice_index_t * index);
+    scpi_bool_t SCPI_ChoiceIndexUnregister(scpi_t * context, const scpi_choice_index_t * index);
+#endif
+    scpi_bool_t SCPI_ChoiceToNameIndexed(scpi_t * context, const scpi_choice_def_t * options, int32_t tag, const char ** text);
 
     scpi_bool_t SCPI_ParamInt32(scpi_t * context, int32_t * value, scpi_bool_t mandatory);
     scpi_bool_t SCPI_ParamUInt32(scpi_t * context, uint32_t * value, scpi_bool_t mandatory);
@@ -139,7 +139,14 @@ extern "C" {
     };
     typedef struct _scpi_const_buffer_t scpi_const_buffer_t;
 
+    struct _scpi_iovec_t {
+        const char * data;
+        size_t len;
+    };
+    typedef struct _scpi_iovec_t scpi_iovec_t;
+
     typedef size_t(*scpi_write_t)(scpi_t * context, const char * data, size_t len);
+    typedef size_t(*scpi_write_vector_t)(scpi_t * context, const scpi_iovec_t * iov, size_t iovcnt);
     typedef scpi_result_t(*scpi_write_control_t)(scpi_t * context, scpi_ctrl_name_t ctrl, scpi_reg_val_t val);
     typedef int (*scpi_error_callback_t)(scpi_t * context, int_fast16_t error);
 
@@ -216,6 +223,16 @@ extern "C" {
     };
     typedef struct _scpi_error_info_heap_t scpi_error_info_heap_t;
 
+#if USE_ERROR_INFO_POOL
+    struct _scpi_error_info_pool_t {
+        uint8_t free_count;
+        uint8_t free_slots[SCPI_ERROR_INFO_POOL_SIZE];
+        uint8_t in_use[SCPI_ERROR_INFO_POOL_SIZE];
+        char slots[SCPI_ERROR_INFO_POOL_SIZE][SCPI_ERROR_INFO_POOL_SLOT_LENGTH];
+    };
+    typedef struct _scpi_error_info_pool_t scpi_error_info_pool_t;
+#endif
+
     struct _scpi_error_t {
         int16_t error_code;
 #if USE_DEVICE_DEPENDENT_ERROR_INFORMATION
@@ -233,6 +250,18 @@ extern "C" {
     };
     typedef struct _scpi_fifo_t scpi_fifo_t;
 
+#if USE_ERROR_ISR_QUEUE
+    /* wr and dropped are written only by producer, rd only by consumer */
+    struct _scpi_fifo_spsc_t {
+        volatile uint16_t wr;
+        volatile uint16_t rd;
+        volatile uint16_t dropped;
+        uint16_t dropped_seen;
+        int16_t data[SCPI_ERROR_ISR_QUEUE_SIZE];
+    };
+    typedef struct _scpi_fifo_spsc_t scpi_fifo_spsc_t;
+#endif
+
     /* scpi units */
     enum _scpi_unit_t {
         SCPI_UNIT_NONE,
@@ -288,7 +317,10 @@ extern "C" {
         SCPI_UNIT_YEAR,
         SCPI_UNIT_STROKES,
         SCPI_UNIT_POISE,
-        SCPI_UNIT_LITER
+        SCPI_UNIT_LITER,
+
+        /* last definition - number of units */
+        SCPI_UNIT_COUNT
     };
     typedef enum _scpi_unit_t scpi_unit_t;
 
@@ -300,6 +332,15 @@ extern "C" {
 #define SCPI_UNITS_LIST_END       {NULL, SCPI_UNIT_NONE, 0}
     typedef struct _scpi_unit_def_t scpi_unit_def_t;
 
+#if USE_UNITS_INDEX
+    struct _scpi_units_index_t {
+        const scpi_unit_def_t * units;
+        uint8_t names[SCPI_UNITS_INDEX_SIZE];
+        uint8_t base[SCPI_UNIT_COUNT];
+    };
+    typedef struct _scpi_units_index_t scpi_units_index_t;
+#endif
+
     enum _scpi_special_number_t {
         SCPI_NUM_NUMBER,
         SCPI_NUM_MIN,
@@ -321,6 +362,15 @@ extern "C" {
 #define SCPI_CHOICE_LIST_END   {NULL, -1}
     typedef struct _scpi_choice_def_t scpi_choice_def_t;
 
+#if USE_CHOICE_INDEX
+    struct _scpi_choice_index_t {
+        const scpi_choice_def_t * options;
+        uint8_t names[SCPI_CHOICE_INDEX_SIZE];
+        uint8_t tags[SCPI_CHOICE_INDEX_SIZE];
+    };
+    typedef struct _scpi_choice_index_t scpi_choice_index_t;
+#endif
+
     struct _scpi_param_list_t {
         const scpi_command_t * cmd;
         lex_state_t lex_state;
@@ -340,6 +390,18 @@ extern "C" {
     };
     typedef struct _scpi_number_parameter_t scpi_number_t;
 
+    struct _scpi_number_scaled_parameter_t {
+        scpi_bool_t special;
+
+        union {
+            int64_t value;
+            int32_t tag;
+        } content;
+        scpi_unit_t unit;
+        int8_t base;
+    };
+    typedef struct _scpi_number_scaled_parameter_t scpi_number_scaled_t;
+
     struct _scpi_data_parameter_t {
         const char * ptr;
         int32_t len;
@@ -362,6 +424,7 @@ extern "C" {
         scpi_write_control_t control;
         scpi_command_callback_t flush;
         scpi_command_callback_t reset;
+        scpi_write_vector_t write_vector;
     };
 
     struct _scpi_t {
@@ -373,11 +436,24 @@ extern "C" {
         int_fast16_t input_count;
         scpi_bool_t cmd_error;
         scpi_fifo_t error_queue;
-#if USE_DEVICE_DEPENDENT_ERROR_INFORMATION && !USE_MEMORY_ALLOCATION_FREE
+#if USE_ERROR_ISR_QUEUE
+        scpi_fifo_spsc_t error_isr_queue;
+#endif
+#if USE_ERROR_INFO_POOL
+        scpi_error_info_pool_t error_info_pool;
+#elif USE_DEVICE_DEPENDENT_ERROR_INFORMATION && !USE_MEMORY_ALLOCATION_FREE
         scpi_error_info_heap_t error_info_heap;
 #endif
         scpi_reg_val_t registers[SCPI_REG_COUNT];
         const scpi_unit_def_t * units;
+#if USE_UNITS_INDEX
+        scpi_units_index_t units_index;
+#endif
+#if USE_CHOICE_INDEX
+        scpi_choice_index_t choice_index_bool;
+        scpi_choice_index_t choice_index_special;
+        const scpi_choice_index_t * choice_index[SCPI_CHOICE_INDEX_COUNT];
+#endif
         void * user_context;
         scpi_parser_state_t parser_state;
         const char * idn[4];
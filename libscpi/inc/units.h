@@ -48,6 +48,7 @@ extern "C" {
     extern const scpi_choice_def_t scpi_special_numbers_def[];
 
     scpi_bool_t SCPI_ParamNumber(scpi_t * context, const scpi_choice_def_t * special, scpi_number_t * value, scpi_bool_t mandatory);
+    scpi_bool_t SCPI_ParamNumberInt64Scaled(scpi_t * context, const scpi_choice_def_t * special, scpi_number_scaled_t * value, int8_t exponent, scpi_bool_t mandatory);
 
     scpi_bool_t SCPI_ParamTranslateNumberVal(scpi_t * context, scpi_parameter_t * parameter);
     size_t SCPI_NumberToStr(scpi_t * context, const scpi_choice_def_t * special, scpi_number_t * value, char * str, size_t len);
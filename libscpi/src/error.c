@@ -54,6 +54,12 @@
  */
 void SCPI_ErrorInit(scpi_t * context, scpi_error_t * data, int16_t size) {
     fifo_init(&context->error_queue, data, size);
+#if USE_ERROR_INFO_POOL
+    scpipool_init(&context->error_info_pool);
+#endif
+#if USE_ERROR_ISR_QUEUE
+    fifo_spsc_init(&context->error_isr_queue);
+#endif
 }
 
 /**
@@ -88,10 +94,11 @@ static void SCPI_ErrorEmit(scpi_t * context, int16_t err) {
  * @param context - scpi context
  */
 void SCPI_ErrorClear(scpi_t * context) {
+    SCPI_ErrorFlushISR(context);
 #if USE_DEVICE_DEPENDENT_ERROR_INFORMATION
     scpi_error_t error;
     while (fifo_remove(&context->error_queue, &error)) {
-        SCPIDEFINE_free(&context->error_info_heap, error.device_dependent_info, false);
+        SCPIDEFINE_free(context, error.device_dependent_info, false);
     }
 #endif
     fifo_clear(&context->error_queue);
@@ -108,6 +115,7 @@ void SCPI_ErrorClear(scpi_t * context) {
 scpi_bool_t SCPI_ErrorPop(scpi_t * context, scpi_error_t * error) {
     if (!error || !context) return FALSE;
     SCPI_ERROR_SETVAL(error, 0, NULL);
+    SCPI_ErrorFlushISR(context);
     fifo_remove(&context->error_queue, error);
 
     SCPI_ErrorEmitEmpty(context);
@@ -123,6 +131,7 @@ scpi_bool_t SCPI_ErrorPop(scpi_t * context, scpi_error_t * error) {
 int32_t SCPI_ErrorCount(scpi_t * context) {
     int16_t result = 0;
 
+    SCPI_ErrorFlushISR(context);
     fifo_count(&context->error_queue, &result);
 
     return result;
@@ -133,12 +142,12 @@ static scpi_bool_t SCPI_ErrorAddInternal(scpi_t * context, int16_t err, char * i
     /* SCPIDEFINE_strndup is sometimes a dumy that does not reference it's arguments. 
        Since info_len is not referenced elsewhere caoing to void prevents unusd argument warnings */
     (void) info_len;
-    char * info_ptr = info ? SCPIDEFINE_strndup(&context->error_info_heap, info, info_len) : NULL;
+    char * info_ptr = info ? SCPIDEFINE_strndup(context, info, info_len) : NULL;
     SCPI_ERROR_SETVAL(&error_value, err, info_ptr);
     if (!fifo_add(&context->error_queue, &error_value)) {
-        SCPIDEFINE_free(&context->error_info_heap, error_value.device_dependent_info, true);
+        SCPIDEFINE_free(context, error_value.device_dependent_info, true);
         fifo_remove_last(&context->error_queue, &error_value);
-        SCPIDEFINE_free(&context->error_info_heap, error_value.device_dependent_info, true);
+        SCPIDEFINE_free(context, error_value.device_dependent_info, true);
         SCPI_ERROR_SETVAL(&error_value, SCPI_ERROR_QUEUE_OVERFLOW, NULL);
         fifo_add(&context->error_queue, &error_value);
         return FALSE;
@@ -167,13 +176,14 @@ static const struct error_reg errs[ERROR_DEFS_N] = {
 };
 
 /**
- * Push error to queue
+ * Push error to queue, set ESR bits and emit it, but do not mark current
+ * command as failed
  * @param context
  * @param err - error number
  * @param info - additional text information or NULL for no text
  * @param info_len - length of text or 0 for automatic length
  */
-void SCPI_ErrorPushEx(scpi_t * context, int16_t err, char * info, size_t info_len) {
+static void SCPI_ErrorPushInternal(scpi_t * context, int16_t err, char * info, size_t info_len) {
     int i;
     /* automatic calculation of length */
     if (info && info_len == 0) {
@@ -191,6 +201,17 @@ void SCPI_ErrorPushEx(scpi_t * context, int16_t err, char * info, size_t info_le
     if (queue_overflow) {
         SCPI_ErrorEmit(context, SCPI_ERROR_QUEUE_OVERFLOW);
     }
+}
+
+/**
+ * Push error to queue
+ * @param context
+ * @param err - error number
+ * @param info - additional text information or NULL for no text
+ * @param info_len - length of text or 0 for automatic length
+ */
+void SCPI_ErrorPushEx(scpi_t * context, int16_t err, char * info, size_t info_len) {
+    SCPI_ErrorPushInternal(context, err, info, info_len);
 
     if (context) {
         context->cmd_error = TRUE;
@@ -207,6 +228,46 @@ void SCPI_ErrorPush(scpi_t * context, int16_t err) {
     return;
 }
 
+/**
+ * Push error from interrupt or other thread than the one running the parser.
+ * Never blocks. Only error code is stored (no device dependent information),
+ * ESR bits and error callback are handled when the error is moved to the error
+ * queue by SCPI_ErrorFlushISR. Only one such producer is allowed per context.
+ * @param context - scpi context
+ * @param err - error number
+ * @return FALSE if the queue was full and error was dropped
+ */
+scpi_bool_t SCPI_ErrorPushFromISR(scpi_t * context, int16_t err) {
+#if USE_ERROR_ISR_QUEUE
+    return fifo_spsc_add(&context->error_isr_queue, err);
+#else
+    (void) context;
+    (void) err;
+    return FALSE;
+#endif
+}
+
+/**
+ * Move errors pushed by SCPI_ErrorPushFromISR to the error queue. Dropped
+ * errors are reported as queue overflow. Called automatically by the parser
+ * and by error queue functions.
+ * @param context - scpi context
+ */
+void SCPI_ErrorFlushISR(scpi_t * context) {
+#if USE_ERROR_ISR_QUEUE
+    int16_t err;
+
+    while (fifo_spsc_remove(&context->error_isr_queue, &err)) {
+        SCPI_ErrorPushInternal(context, err, NULL, 0);
+    }
+    if (fifo_spsc_dropped(&context->error_isr_queue) > 0) {
+        SCPI_ErrorPushInternal(context, SCPI_ERROR_QUEUE_OVERFLOW, NULL, 0);
+    }
+#else
+    (void) context;
+#endif
+}
+
 /**
  * Translate error number to string
  * @param err - error number
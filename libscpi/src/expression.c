@@ -34,11 +34,13 @@
  *
  */
 
+#include <string.h>
 #include "expression.h"
 #include "error.h"
 #include "parser.h"
 
 #include "lexer_private.h"
+#include "utils_private.h"
 
 /**
  * Parse one range or single value
@@ -68,6 +70,210 @@ static scpi_expr_result_t numericRange(lex_state_t * state, scpi_bool_t * isRang
     return SCPI_EXPR_NO_MORE;
 }
 
+/**
+ * Start iteration over numeric list expression
+ * @param context scpi context
+ * @param param input parameter
+ * @param list iterator state
+ * @return SCPI_EXPR_OK - parameter is expression
+ *         SCPI_EXPR_ERROR - wrong parameter type
+ * @see SCPI_ExprNumericListNext
+ */
+scpi_expr_result_t SCPI_ExprNumericListBegin(scpi_t * context, scpi_parameter_t * param, scpi_expr_list_t * list) {
+    if (!param || !list) {
+        SCPI_ErrorPush(context, SCPI_ERROR_SYSTEM_ERROR);
+        return SCPI_EXPR_ERROR;
+    }
+
+    if (param->type != SCPI_TOKEN_PROGRAM_EXPRESSION) {
+        SCPI_ErrorPush(context, SCPI_ERROR_DATA_TYPE_ERROR);
+        return SCPI_EXPR_ERROR;
+    }
+
+    list->lex.buffer = param->ptr + 1;
+    list->lex.pos = list->lex.buffer;
+    list->lex.len = param->len - 2;
+    list->index = 0;
+
+    return SCPI_EXPR_OK;
+}
+
+/**
+ * Skip separator in front of next list entry
+ * @param list iterator state
+ * @return SCPI_EXPR_OK - next entry can be parsed
+ *         SCPI_EXPR_ERROR - missing separator
+ *         SCPI_EXPR_NO_MORE - end of list
+ */
+static scpi_expr_result_t listSeparator(scpi_expr_list_t * list) {
+    scpi_token_t token;
+
+    if (list->index == 0) {
+        return SCPI_EXPR_OK;
+    }
+
+    if (!scpiLex_Comma(&list->lex, &token)) {
+        return scpiLex_IsEos(&list->lex) ? SCPI_EXPR_NO_MORE : SCPI_EXPR_ERROR;
+    }
+
+    return SCPI_EXPR_OK;
+}
+
+/**
+ * Parse next entry of numeric list. Lexer position is kept in the iterator,
+ * so walking the whole list is linear in its length.
+ * @param context scpi context
+ * @param list iterator state from SCPI_ExprNumericListBegin
+ * @param isRange return true if expression was range
+ * @param valueFrom return value from
+ * @param valueTo return value to
+ * @return SCPI_EXPR_OK - parsing was succesful
+ *         SCPI_EXPR_ERROR - parser error
+ *         SCPI_EXPR_NO_MORE - no more data
+ * @see SCPI_ExprNumericListNextInt, SCPI_ExprNumericListNextDouble
+ */
+scpi_expr_result_t SCPI_ExprNumericListNext(scpi_t * context, scpi_expr_list_t * list, scpi_bool_t * isRange, scpi_parameter_t * valueFrom, scpi_parameter_t * valueTo) {
+    scpi_expr_result_t res;
+
+    if (!list || !isRange || !valueFrom || !valueTo) {
+        SCPI_ErrorPush(context, SCPI_ERROR_SYSTEM_ERROR);
+        return SCPI_EXPR_ERROR;
+    }
+
+    res = listSeparator(list);
+    if (res == SCPI_EXPR_OK) {
+        res = numericRange(&list->lex, isRange, valueFrom, valueTo);
+    }
+
+    if (res == SCPI_EXPR_OK) {
+        list->index++;
+    } else if (res == SCPI_EXPR_ERROR) {
+        SCPI_ErrorPush(context, SCPI_ERROR_EXPRESSION_PARSING_ERROR);
+    }
+    return res;
+}
+
+/**
+ * Parse next entry of numeric list and convert result to int32_t
+ * @param context scpi context
+ * @param list iterator state from SCPI_ExprNumericListBegin
+ * @param isRange return true if expression was range
+ * @param valueFrom return value from
+ * @param valueTo return value to
+ * @return SCPI_EXPR_OK - parsing was succesful
+ *         SCPI_EXPR_ERROR - parser error
+ *         SCPI_EXPR_NO_MORE - no more data
+ */
+scpi_expr_result_t SCPI_ExprNumericListNextInt(scpi_t * context, scpi_expr_list_t * list, scpi_bool_t * isRange, int32_t * valueFrom, int32_t * valueTo) {
+    scpi_expr_result_t res;
+    scpi_bool_t range = FALSE;
+    scpi_parameter_t paramFrom;
+    scpi_parameter_t paramTo;
+
+    res = SCPI_ExprNumericListNext(context, list, &range, &paramFrom, &paramTo);
+    if (res == SCPI_EXPR_OK) {
+        *isRange = range;
+        SCPI_ParamToInt32(context, &paramFrom, valueFrom);
+        if (range) {
+            SCPI_ParamToInt32(context, &paramTo, valueTo);
+        }
+    }
+
+    return res;
+}
+
+/**
+ * Parse next entry of numeric list and convert result to double
+ * @param context scpi context
+ * @param list iterator state from SCPI_ExprNumericListBegin
+ * @param isRange return true if expression was range
+ * @param valueFrom return value from
+ * @param valueTo return value to
+ * @return SCPI_EXPR_OK - parsing was succesful
+ *         SCPI_EXPR_ERROR - parser error
+ *         SCPI_EXPR_NO_MORE - no more data
+ */
+scpi_expr_result_t SCPI_ExprNumericListNextDouble(scpi_t * context, scpi_expr_list_t * list, scpi_bool_t * isRange, double * valueFrom, double * valueTo) {
+    scpi_expr_result_t res;
+    scpi_bool_t range = FALSE;
+    scpi_parameter_t paramFrom;
+    scpi_parameter_t paramTo;
+
+    res = SCPI_ExprNumericListNext(context, list, &range, &paramFrom, &paramTo);
+    if (res == SCPI_EXPR_OK) {
+        *isRange = range;
+        SCPI_ParamToDouble(context, &paramFrom, valueFrom);
+        if (range) {
+            SCPI_ParamToDouble(context, &paramTo, valueTo);
+        }
+    }
+
+    return res;
+}
+
+/**
+ * Expand range to array, descending range (e.g. 5:1) is expanded downwards
+ * @param context scpi context
+ * @param from first value
+ * @param to last value
+ * @param data array to fill
+ * @param i_count number of elements of data
+ * @param o_count number of already filled elements, updated
+ * @return SCPI_EXPR_OK or SCPI_EXPR_ERROR if data are full
+ */
+static scpi_expr_result_t expandRange(scpi_t * context, int32_t from, int32_t to, int32_t * data, size_t i_count, size_t * o_count) {
+    int64_t value = from;
+    int64_t step = (to >= from) ? 1 : -1;
+    uint64_t count = (uint64_t) ((to >= from) ? ((int64_t) to - from) : ((int64_t) from - to)) + 1;
+
+    if (count > i_count - *o_count) {
+        SCPI_ErrorPush(context, SCPI_ERROR_TOO_MUCH_DATA);
+        return SCPI_EXPR_ERROR;
+    }
+
+    while (count--) {
+        data[(*o_count)++] = (int32_t) value;
+        value += step;
+    }
+
+    return SCPI_EXPR_OK;
+}
+
+/**
+ * Decode whole numeric list to array of int32_t with expanded ranges
+ * e.g. "(1:3,7)" is decoded to 1, 2, 3, 7
+ * @param context scpi context
+ * @param param input parameter
+ * @param data array to fill
+ * @param i_count number of elements of data
+ * @param o_count real number of filled elements
+ * @return SCPI_EXPR_OK - whole list was decoded
+ *         SCPI_EXPR_ERROR - parser error or list does not fit to data
+ */
+scpi_expr_result_t SCPI_ExprNumericListToArrayInt(scpi_t * context, scpi_parameter_t * param, int32_t * data, size_t i_count, size_t * o_count) {
+    scpi_expr_list_t list;
+    scpi_expr_result_t res;
+    scpi_bool_t isRange;
+    int32_t valueFrom;
+    int32_t valueTo;
+
+    if (!o_count || (i_count && !data)) {
+        SCPI_ErrorPush(context, SCPI_ERROR_SYSTEM_ERROR);
+        return SCPI_EXPR_ERROR;
+    }
+
+    *o_count = 0;
+    res = SCPI_ExprNumericListBegin(context, param, &list);
+    while (res == SCPI_EXPR_OK) {
+        res = SCPI_ExprNumericListNextInt(context, &list, &isRange, &valueFrom, &valueTo);
+        if (res == SCPI_EXPR_OK) {
+            res = expandRange(context, valueFrom, isRange ? valueTo : valueFrom, data, i_count, o_count);
+        }
+    }
+
+    return (res == SCPI_EXPR_NO_MORE) ? SCPI_EXPR_OK : res;
+}
+
 /**
  * Parse entry on specified position
  * @param context scpi context
@@ -82,40 +288,20 @@ static scpi_expr_result_t numericRange(lex_state_t * state, scpi_bool_t * isRang
  * @see SCPI_ExprNumericListEntryInt, SCPI_ExprNumericListEntryDouble
  */
 scpi_expr_result_t SCPI_ExprNumericListEntry(scpi_t * context, scpi_parameter_t * param, int index, scpi_bool_t * isRange, scpi_parameter_t * valueFrom, scpi_parameter_t * valueTo) {
-    lex_state_t lex;
+    scpi_expr_list_t list;
     int i;
-    scpi_expr_result_t res = SCPI_EXPR_OK;
+    scpi_expr_result_t res;
 
     if (!isRange || !valueFrom || !valueTo || !param) {
         SCPI_ErrorPush(context, SCPI_ERROR_SYSTEM_ERROR);
         return SCPI_EXPR_ERROR;
     }
 
-    if (param->type != SCPI_TOKEN_PROGRAM_EXPRESSION) {
-        SCPI_ErrorPush(context, SCPI_ERROR_DATA_TYPE_ERROR);
-        return SCPI_EXPR_ERROR;
-    }
-
-    lex.buffer = param->ptr + 1;
-    lex.pos = lex.buffer;
-    lex.len = param->len - 2;
-
-    for (i = 0; i <= index; i++) {
-        res = numericRange(&lex, isRange, valueFrom, valueTo);
-        if (res != SCPI_EXPR_OK) {
-            break;
-        }
-        if (i != index) {
-            if (!scpiLex_Comma(&lex, valueFrom)) {
-                res = scpiLex_IsEos(&lex) ? SCPI_EXPR_NO_MORE : SCPI_EXPR_ERROR;
-                break;
-            }
-        }
+    res = SCPI_ExprNumericListBegin(context, param, &list);
+    for (i = 0; (i <= index) && (res == SCPI_EXPR_OK); i++) {
+        res = SCPI_ExprNumericListNext(context, &list, isRange, valueFrom, valueTo);
     }
 
-    if (res == SCPI_EXPR_ERROR) {
-        SCPI_ErrorPush(context, SCPI_ERROR_EXPRESSION_PARSING_ERROR);
-    }
     return res;
 }
 
@@ -253,6 +439,104 @@ static scpi_expr_result_t channelRange(scpi_t * context, lex_state_t * state, sc
     return err;
 }
 
+/**
+ * Start iteration over channel list expression e.g. "(@1!2:5!6,7)"
+ * @param context
+ * @param param
+ * @param list iterator state
+ * @return SCPI_EXPR_OK - parameter is channel list expression
+ *         SCPI_EXPR_ERROR - wrong parameter
+ * @see SCPI_ExprChannelListNext
+ */
+scpi_expr_result_t SCPI_ExprChannelListBegin(scpi_t * context, scpi_parameter_t * param, scpi_expr_list_t * list) {
+    scpi_token_t token;
+    scpi_expr_result_t res;
+
+    res = SCPI_ExprNumericListBegin(context, param, list);
+    if (res != SCPI_EXPR_OK) {
+        return res;
+    }
+
+    /* detect channel list expression */
+    if (!scpiLex_SpecificCharacter(&list->lex, &token, '@')) {
+        SCPI_ErrorPush(context, SCPI_ERROR_EXPRESSION_PARSING_ERROR);
+        return SCPI_EXPR_ERROR;
+    }
+
+    return SCPI_EXPR_OK;
+}
+
+/**
+ * Parse next channel list entry e.g. "1!2:5!6"
+ * @param context
+ * @param list iterator state from SCPI_ExprChannelListBegin
+ * @param isRange return true if it is range
+ * @param valuesFrom return array of values from
+ * @param valuesTo return array of values to
+ * @param length length of values arrays
+ * @param dimensions real number of dimensions
+ */
+scpi_expr_result_t SCPI_ExprChannelListNext(scpi_t * context, scpi_expr_list_t * list, scpi_bool_t * isRange, int32_t * valuesFrom, int32_t * valuesTo, size_t length, size_t * dimensions) {
+    scpi_expr_result_t res;
+
+    if (!list || !isRange || !dimensions || (length && (!valuesFrom || !valuesTo))) {
+        SCPI_ErrorPush(context, SCPI_ERROR_SYSTEM_ERROR);
+        return SCPI_EXPR_ERROR;
+    }
+
+    res = listSeparator(list);
+    if (res == SCPI_EXPR_OK) {
+        res = channelRange(context, &list->lex, isRange, valuesFrom, valuesTo, length, dimensions);
+    }
+
+    if (res == SCPI_EXPR_OK) {
+        list->index++;
+    } else if (res == SCPI_EXPR_ERROR) {
+        SCPI_ErrorPush(context, SCPI_ERROR_EXPRESSION_PARSING_ERROR);
+    }
+    return res;
+}
+
+/**
+ * Decode whole one-dimensional channel list to array with expanded ranges
+ * e.g. "(@1:5,7,9:200)"
+ * @param context
+ * @param param
+ * @param data array to fill
+ * @param i_count number of elements of data
+ * @param o_count real number of filled elements
+ * @return SCPI_EXPR_OK - whole list was decoded
+ *         SCPI_EXPR_ERROR - parser error, multi-dimensional entry or list does not fit to data
+ */
+scpi_expr_result_t SCPI_ExprChannelListToArray(scpi_t * context, scpi_parameter_t * param, int32_t * data, size_t i_count, size_t * o_count) {
+    scpi_expr_list_t list;
+    scpi_expr_result_t res;
+    scpi_bool_t isRange;
+    int32_t valueFrom;
+    int32_t valueTo;
+    size_t dimensions;
+
+    if (!o_count || (i_count && !data)) {
+        SCPI_ErrorPush(context, SCPI_ERROR_SYSTEM_ERROR);
+        return SCPI_EXPR_ERROR;
+    }
+
+    *o_count = 0;
+    res = SCPI_ExprChannelListBegin(context, param, &list);
+    while (res == SCPI_EXPR_OK) {
+        res = SCPI_ExprChannelListNext(context, &list, &isRange, &valueFrom, &valueTo, 1, &dimensions);
+        if (res == SCPI_EXPR_OK) {
+            if (dimensions != 1) {
+                SCPI_ErrorPush(context, SCPI_ERROR_ILLEGAL_PARAMETER_VALUE);
+                return SCPI_EXPR_ERROR;
+            }
+            res = expandRange(context, valueFrom, isRange ? valueTo : valueFrom, data, i_count, o_count);
+        }
+    }
+
+    return (res == SCPI_EXPR_NO_MORE) ? SCPI_EXPR_OK : res;
+}
+
 /**
  * Parse one list entry at specific position e.g. "1!2:5!6"
  * @param context
@@ -265,52 +549,256 @@ static scpi_expr_result_t channelRange(scpi_t * context, lex_state_t * state, sc
  * @param dimensions real number of dimensions
  */
 scpi_expr_result_t SCPI_ExprChannelListEntry(scpi_t * context, scpi_parameter_t * param, int index, scpi_bool_t * isRange, int32_t * valuesFrom, int32_t * valuesTo, size_t length, size_t * dimensions) {
-    lex_state_t lex;
+    scpi_expr_list_t list;
     int i;
-    scpi_expr_result_t res = SCPI_EXPR_OK;
-    scpi_token_t token;
+    scpi_expr_result_t res;
 
     if (!isRange || !param || !dimensions || (length && (!valuesFrom || !valuesTo))) {
         SCPI_ErrorPush(context, SCPI_ERROR_SYSTEM_ERROR);
         return SCPI_EXPR_ERROR;
     }
 
-    if (param->type != SCPI_TOKEN_PROGRAM_EXPRESSION) {
-        SCPI_ErrorPush(context, SCPI_ERROR_DATA_TYPE_ERROR);
-        return SCPI_EXPR_ERROR;
+    res = SCPI_ExprChannelListBegin(context, param, &list);
+    for (i = 0; (i <= index) && (res == SCPI_EXPR_OK); i++) {
+        res = SCPI_ExprChannelListNext(context, &list, isRange, valuesFrom, valuesTo, (i == index) ? length : 0, dimensions);
     }
 
-    lex.buffer = param->ptr + 1;
-    lex.pos = lex.buffer;
-    lex.len = param->len - 2;
+    return res;
+}
+
+/**
+ * Initialize empty range set over caller supplied storage
+ * @param set range set
+ * @param ranges storage for ranges
+ * @param capacity number of elements of ranges
+ */
+void SCPI_ExprRangeSetInit(scpi_expr_range_set_t * set, scpi_expr_range_t * ranges, size_t capacity) {
+    set->ranges = ranges;
+    set->capacity = ranges ? capacity : 0;
+    set->count = 0;
+}
 
-    /* detect channel list expression */
-    if (!scpiLex_SpecificCharacter(&lex, &token, '@')) {
-        SCPI_ErrorPush(context, SCPI_ERROR_EXPRESSION_PARSING_ERROR);
-        return SCPI_EXPR_ERROR;
+/**
+ * Find first range which ends at or after value
+ * @param set range set
+ * @param value
+ * @return position of range or set->count
+ */
+static size_t rangeSetLowerBound(const scpi_expr_range_set_t * set, int64_t value) {
+    size_t lo = 0;
+    size_t hi = set->count;
+    size_t mid;
+
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        if (set->ranges[mid].to < value) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
     }
 
-    for (i = 0; i <= index; i++) {
-        res = channelRange(context, &lex, isRange, valuesFrom, valuesTo, (i == index) ? length : 0, dimensions);
-        if (res != SCPI_EXPR_OK) {
-            break;
+    return lo;
+}
+
+/**
+ * Add range to the set. Ranges are kept sorted, overlapping and adjacent
+ * ranges are merged. Descending range (e.g. 5:1) is added as 1:5.
+ * @param set range set
+ * @param from first value
+ * @param to last value
+ * @return FALSE if there is no space for new range
+ */
+scpi_bool_t SCPI_ExprRangeSetAdd(scpi_expr_range_set_t * set, int32_t from, int32_t to) {
+    size_t i;
+    size_t j;
+
+    if (from > to) {
+        int32_t tmp = from;
+        from = to;
+        to = tmp;
+    }
+
+    i = rangeSetLowerBound(set, (int64_t) from - 1);
+    for (j = i; (j < set->count) && ((int64_t) set->ranges[j].from <= (int64_t) to + 1); j++) {
+        from = min(from, set->ranges[j].from);
+        to = max(to, set->ranges[j].to);
+    }
+
+    if (j == i) {
+        if (set->count >= set->capacity) {
+            return FALSE;
         }
-        if (i != index) {
-            if (!scpiLex_Comma(&lex, &token)) {
-                res = scpiLex_IsEos(&lex) ? SCPI_EXPR_NO_MORE : SCPI_EXPR_ERROR;
-                break;
-            }
+        memmove(&set->ranges[i + 1], &set->ranges[i], (set->count - i) * sizeof (scpi_expr_range_t));
+        set->count++;
+    } else {
+        memmove(&set->ranges[i + 1], &set->ranges[j], (set->count - j) * sizeof (scpi_expr_range_t));
+        set->count -= j - i - 1;
+    }
+
+    set->ranges[i].from = from;
+    set->ranges[i].to = to;
+    return TRUE;
+}
+
+/**
+ * Test membership in O(log n)
+ * @param set range set
+ * @param value
+ * @return TRUE if value is in some range of the set
+ */
+scpi_bool_t SCPI_ExprRangeSetContains(const scpi_expr_range_set_t * set, int32_t value) {
+    size_t i = rangeSetLowerBound(set, value);
+
+    return ((i < set->count) && (set->ranges[i].from <= value)) ? TRUE : FALSE;
+}
+
+/**
+ * Count values in the set
+ * @param set range set
+ * @return number of values
+ */
+uint64_t SCPI_ExprRangeSetCount(const scpi_expr_range_set_t * set) {
+    uint64_t count = 0;
+    size_t i;
+
+    for (i = 0; i < set->count; i++) {
+        count += (uint64_t) ((int64_t) set->ranges[i].to - set->ranges[i].from) + 1;
+    }
+
+    return count;
+}
+
+/**
+ * Get the lowest value of the set
+ * @param set range set
+ * @param value result
+ * @return FALSE if the set is empty
+ */
+scpi_bool_t SCPI_ExprRangeSetFirst(const scpi_expr_range_set_t * set, int32_t * value) {
+    if (set->count == 0) {
+        return FALSE;
+    }
+
+    *value = set->ranges[0].from;
+    return TRUE;
+}
+
+/**
+ * Get the lowest value of the set greater than value
+ * @param set range set
+ * @param value previous value on input, next value on output
+ * @return FALSE if there is no more values
+ */
+scpi_bool_t SCPI_ExprRangeSetNext(const scpi_expr_range_set_t * set, int32_t * value) {
+    size_t i = rangeSetLowerBound(set, (int64_t) *value + 1);
+
+    if (i >= set->count) {
+        return FALSE;
+    }
+
+    *value = max(set->ranges[i].from, *value + 1);
+    return TRUE;
+}
+
+/**
+ * Convert set to bitmap, bit n (LSB first) represents value offset + n
+ * @param set range set
+ * @param offset value of the first bit
+ * @param bitmap result, (bits + 7) / 8 bytes
+ * @param bits number of bits of bitmap
+ * @return FALSE if some value of the set is out of bitmap domain
+ */
+scpi_bool_t SCPI_ExprRangeSetToBitmap(const scpi_expr_range_set_t * set, int32_t offset, uint8_t * bitmap, size_t bits) {
+    size_t i;
+    uint64_t bit;
+    uint64_t last;
+
+    memset(bitmap, 0, (bits + 7) / 8);
+
+    for (i = 0; i < set->count; i++) {
+        if ((set->ranges[i].from < offset) || ((uint64_t) ((int64_t) set->ranges[i].to - offset) >= bits)) {
+            return FALSE;
+        }
+        last = (uint64_t) ((int64_t) set->ranges[i].to - offset);
+        for (bit = (uint64_t) ((int64_t) set->ranges[i].from - offset); bit <= last; bit++) {
+            bitmap[bit / 8] |= (uint8_t) (1 << (bit % 8));
         }
     }
 
-    if (res == SCPI_EXPR_ERROR) {
-        SCPI_ErrorPush(context, SCPI_ERROR_EXPRESSION_PARSING_ERROR);
+    return TRUE;
+}
+
+/**
+ * Parse numeric list to sorted set of merged ranges
+ * e.g. "(1:1000,2000:3000,5)" needs three ranges only
+ * @param context scpi context
+ * @param param input parameter
+ * @param set range set initialized by SCPI_ExprRangeSetInit, it is cleared first
+ * @return SCPI_EXPR_OK - whole list was parsed
+ *         SCPI_EXPR_ERROR - parser error or set is full
+ */
+scpi_expr_result_t SCPI_ExprNumericListToRangeSet(scpi_t * context, scpi_parameter_t * param, scpi_expr_range_set_t * set) {
+    scpi_expr_list_t list;
+    scpi_expr_result_t res;
+    scpi_bool_t isRange;
+    int32_t valueFrom;
+    int32_t valueTo;
+
+    if (!set) {
+        SCPI_ErrorPush(context, SCPI_ERROR_SYSTEM_ERROR);
+        return SCPI_EXPR_ERROR;
     }
-    if (res == SCPI_EXPR_NO_MORE) {
-        if (!scpiLex_IsEos(&lex)) {
+
+    set->count = 0;
+    res = SCPI_ExprNumericListBegin(context, param, &list);
+    while (res == SCPI_EXPR_OK) {
+        res = SCPI_ExprNumericListNextInt(context, &list, &isRange, &valueFrom, &valueTo);
+        if ((res == SCPI_EXPR_OK) && !SCPI_ExprRangeSetAdd(set, valueFrom, isRange ? valueTo : valueFrom)) {
+            SCPI_ErrorPush(context, SCPI_ERROR_TOO_MUCH_DATA);
             res = SCPI_EXPR_ERROR;
-            SCPI_ErrorPush(context, SCPI_ERROR_EXPRESSION_PARSING_ERROR);
         }
     }
-    return res;
+
+    return (res == SCPI_EXPR_NO_MORE) ? SCPI_EXPR_OK : res;
+}
+
+/**
+ * Parse one-dimensional channel list to sorted set of merged ranges
+ * @param context scpi context
+ * @param param input parameter
+ * @param set range set initialized by SCPI_ExprRangeSetInit, it is cleared first
+ * @return SCPI_EXPR_OK - whole list was parsed
+ *         SCPI_EXPR_ERROR - parser error, multi-dimensional entry or set is full
+ */
+scpi_expr_result_t SCPI_ExprChannelListToRangeSet(scpi_t * context, scpi_parameter_t * param, scpi_expr_range_set_t * set) {
+    scpi_expr_list_t list;
+    scpi_expr_result_t res;
+    scpi_bool_t isRange;
+    int32_t valueFrom;
+    int32_t valueTo;
+    size_t dimensions;
+
+    if (!set) {
+        SCPI_ErrorPush(context, SCPI_ERROR_SYSTEM_ERROR);
+        return SCPI_EXPR_ERROR;
+    }
+
+    set->count = 0;
+    res = SCPI_ExprChannelListBegin(context, param, &list);
+    while (res == SCPI_EXPR_OK) {
+        res = SCPI_ExprChannelListNext(context, &list, &isRange, &valueFrom, &valueTo, 1, &dimensions);
+        if (res == SCPI_EXPR_OK) {
+            if (dimensions != 1) {
+                SCPI_ErrorPush(context, SCPI_ERROR_ILLEGAL_PARAMETER_VALUE);
+                return SCPI_EXPR_ERROR;
+            }
+            if (!SCPI_ExprRangeSetAdd(set, valueFrom, isRange ? valueTo : valueFrom)) {
+                SCPI_ErrorPush(context, SCPI_ERROR_TOO_MUCH_DATA);
+                res = SCPI_EXPR_ERROR;
+            }
+        }
+    }
+
+    return (res == SCPI_EXPR_NO_MORE) ? SCPI_EXPR_OK : res;
 }
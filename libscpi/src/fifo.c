@@ -144,3 +144,98 @@ scpi_bool_t fifo_count(scpi_fifo_t * fifo, int16_t * value) {
     *value = fifo->count;
     return TRUE;
 }
+
+#if USE_ERROR_ISR_QUEUE
+
+#if (SCPI_ERROR_ISR_QUEUE_SIZE & (SCPI_ERROR_ISR_QUEUE_SIZE - 1)) != 0
+#error SCPI_ERROR_ISR_QUEUE_SIZE must be power of two
+#endif
+
+/*
+ * Index load with acquire and store with release semantics. GCC/Clang
+ * builtins follow C11 memory model on plain variables, C11 fences are used
+ * with other compilers supporting them. Otherwise only volatile access is
+ * left, which is sufficient on single core targets.
+ */
+#if defined(__ATOMIC_ACQUIRE) && defined(__ATOMIC_RELEASE)
+#define SPSC_LOAD_ACQUIRE(v) __atomic_load_n(&(v), __ATOMIC_ACQUIRE)
+#define SPSC_STORE_RELEASE(v, x) __atomic_store_n(&(v), (x), __ATOMIC_RELEASE)
+#elif defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+#define SPSC_LOAD_ACQUIRE(v) spsc_load_acquire(&(v))
+#define SPSC_STORE_RELEASE(v, x) do { atomic_thread_fence(memory_order_release); (v) = (x); } while(0)
+
+static uint16_t spsc_load_acquire(volatile uint16_t * v) {
+    uint16_t result = *v;
+    atomic_thread_fence(memory_order_acquire);
+    return result;
+}
+#else
+#define SPSC_LOAD_ACQUIRE(v) (v)
+#define SPSC_STORE_RELEASE(v, x) ((v) = (x))
+#endif
+
+/**
+ * Initialize single producer single consumer fifo
+ * @param fifo
+ */
+void fifo_spsc_init(scpi_fifo_spsc_t * fifo) {
+    fifo->wr = 0;
+    fifo->rd = 0;
+    fifo->dropped = 0;
+    fifo->dropped_seen = 0;
+}
+
+/**
+ * Add element to fifo. Called only by producer, never blocks. If fifo is
+ * full, element is dropped and counted.
+ * @param fifo
+ * @param value
+ * @return FALSE - fifo is full
+ */
+scpi_bool_t fifo_spsc_add(scpi_fifo_spsc_t * fifo, int16_t value) {
+    uint16_t wr = fifo->wr;
+
+    if ((uint16_t) (wr - SPSC_LOAD_ACQUIRE(fifo->rd)) >= SCPI_ERROR_ISR_QUEUE_SIZE) {
+        fifo->dropped = fifo->dropped + 1;
+        return FALSE;
+    }
+
+    fifo->data[wr % SCPI_ERROR_ISR_QUEUE_SIZE] = value;
+    SPSC_STORE_RELEASE(fifo->wr, (uint16_t) (wr + 1));
+    return TRUE;
+}
+
+/**
+ * Remove element from fifo. Called only by consumer.
+ * @param fifo
+ * @param value
+ * @return FALSE - fifo is empty
+ */
+scpi_bool_t fifo_spsc_remove(scpi_fifo_spsc_t * fifo, int16_t * value) {
+    uint16_t rd = fifo->rd;
+
+    if (rd == SPSC_LOAD_ACQUIRE(fifo->wr)) {
+        return FALSE;
+    }
+
+    *value = fifo->data[rd % SCPI_ERROR_ISR_QUEUE_SIZE];
+    SPSC_STORE_RELEASE(fifo->rd, (uint16_t) (rd + 1));
+    return TRUE;
+}
+
+/**
+ * Number of elements dropped by producer since last call. Called only by
+ * consumer.
+ * @param fifo
+ * @return
+ */
+uint16_t fifo_spsc_dropped(scpi_fifo_spsc_t * fifo) {
+    uint16_t dropped = SPSC_LOAD_ACQUIRE(fifo->dropped);
+    uint16_t result = (uint16_t) (dropped - fifo->dropped_seen);
+
+    fifo->dropped_seen = dropped;
+    return result;
+}
+
+#endif
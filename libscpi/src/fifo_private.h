@@ -54,6 +54,13 @@ extern "C" {
     scpi_bool_t fifo_remove_last(scpi_fifo_t * fifo, scpi_error_t * value) LOCAL;
     scpi_bool_t fifo_count(scpi_fifo_t * fifo, int16_t * value) LOCAL;
 
+#if USE_ERROR_ISR_QUEUE
+    void fifo_spsc_init(scpi_fifo_spsc_t * fifo) LOCAL;
+    scpi_bool_t fifo_spsc_add(scpi_fifo_spsc_t * fifo, int16_t value) LOCAL;
+    scpi_bool_t fifo_spsc_remove(scpi_fifo_spsc_t * fifo, int16_t * value) LOCAL;
+    uint16_t fifo_spsc_dropped(scpi_fifo_spsc_t * fifo) LOCAL;
+#endif
+
 #ifdef	__cplusplus
 }
 #endif
@@ -83,11 +83,32 @@ scpi_result_t SCPI_SystemErrorNextQ(scpi_t * context) {
     SCPI_ErrorPop(context, &error);
     SCPI_ResultError(context, &error);
 #if USE_DEVICE_DEPENDENT_ERROR_INFORMATION
-    SCPIDEFINE_free(&context->error_info_heap, error.device_dependent_info, false);
+    SCPIDEFINE_free(context, error.device_dependent_info, false);
 #endif
     return SCPI_RES_OK;
 }
 
+/**
+ * SYSTem:ERRor:ALL?
+ * Pop all errors (at most SCPI_SYSTEM_ERROR_ALL_MAX) in one response,
+ * 0,"No error" if the queue is empty
+ * @param context
+ * @return
+ */
+scpi_result_t SCPI_SystemErrorAllQ(scpi_t * context) {
+    int32_t count = SCPI_ErrorCount(context);
+
+    if (count > SCPI_SYSTEM_ERROR_ALL_MAX) {
+        count = SCPI_SYSTEM_ERROR_ALL_MAX;
+    }
+
+    do {
+        SCPI_SystemErrorNextQ(context);
+    } while (--count > 0);
+
+    return SCPI_RES_OK;
+}
+
 /**
  * SYSTem:ERRor:COUNt?
  * @param context
@@ -99,6 +120,21 @@ scpi_result_t SCPI_SystemErrorCountQ(scpi_t * context) {
     return SCPI_RES_OK;
 }
 
+/**
+ * SYSTem:ERRor:STATus?
+ * Number of errors in the queue and Event Status Register in one response.
+ * ESR is cleared as by *ESR?
+ * @param context
+ * @return
+ */
+scpi_result_t SCPI_SystemErrorStatusQ(scpi_t * context) {
+    SCPI_ResultInt32(context, SCPI_ErrorCount(context));
+    SCPI_ResultInt32(context, SCPI_RegGet(context, SCPI_REG_ESR));
+    SCPI_RegSet(context, SCPI_REG_ESR, 0);
+
+    return SCPI_RES_OK;
+}
+
 /**
  * STATus:QUEStionable:CONDition?
  * @param context
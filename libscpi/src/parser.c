@@ -36,11 +36,18 @@
  */
 
 #include <ctype.h>
+#include <float.h>
 #include <string.h>
 
 #include "config.h"
+#if USE_PARALLEL_ARRAY_FORMAT
+#include <stdlib.h>
+#include <pthread.h>
+#endif
 #include "parser.h"
 #include "parser_private.h"
+#include "units.h"
+#include "units_private.h"
 #include "lexer_private.h"
 #include "error.h"
 #include "constants.h"
@@ -190,6 +197,8 @@ scpi_bool_t SCPI_Parse(scpi_t * context, char * data, int len) {
     scpi_parser_state_t * state;
     int r;
     scpi_token_t cmd_prev = {SCPI_TOKEN_UNKNOWN, NULL, 0};
+    char header[SCPI_HEADER_FOLD_LENGTH];
+    const char * header_ptr;
 
     if (context == NULL) {
         return FALSE;
@@ -198,6 +207,8 @@ scpi_bool_t SCPI_Parse(scpi_t * context, char * data, int len) {
     state = &context->parser_state;
     context->output_count = 0;
 
+    SCPI_ErrorFlushISR(context);
+
     while (1) {
         r = scpiParser_detectProgramMessageUnit(state, data, len);
 
@@ -208,7 +219,15 @@ scpi_bool_t SCPI_Parse(scpi_t * context, char * data, int len) {
 
             composeCompoundCommand(&cmd_prev, &state->programHeader);
 
-            if (findCommandHeader(context, state->programHeader.ptr, state->programHeader.len)) {
+            /* fold private copy of header once, pattern compares then match it without case folding */
+            header_ptr = state->programHeader.ptr;
+            if ((size_t) state->programHeader.len <= sizeof (header)) {
+                memcpy(header, state->programHeader.ptr, state->programHeader.len);
+                strToUpper(header, state->programHeader.len);
+                header_ptr = header;
+            }
+
+            if (findCommandHeader(context, header_ptr, state->programHeader.len)) {
 
                 context->param_list.lex_state.buffer = state->programData.ptr;
                 context->param_list.lex_state.pos = context->param_list.lex_state.buffer;
@@ -270,6 +289,17 @@ void SCPI_Init(scpi_t * context,
     context->cmdlist = commands;
     context->interface = interface;
     context->units = units;
+#if USE_UNITS_INDEX
+    scpiUnits_initIndex(&context->units_index, units);
+#endif
+#if USE_CHOICE_INDEX
+    if (SCPI_ChoiceIndexInit(&context->choice_index_bool, scpi_bool_def)) {
+        SCPI_ChoiceIndexRegister(context, &context->choice_index_bool);
+    }
+    if (SCPI_ChoiceIndexInit(&context->choice_index_special, scpi_special_numbers_def)) {
+        SCPI_ChoiceIndexRegister(context, &context->choice_index_special);
+    }
+#endif
     context->idn[0] = idn1;
     context->idn[1] = idn2;
     context->idn[2] = idn3;
@@ -280,7 +310,7 @@ void SCPI_Init(scpi_t * context,
     SCPI_ErrorInit(context, error_queue_data, error_queue_size);
 }
 
-#if USE_DEVICE_DEPENDENT_ERROR_INFORMATION && !USE_MEMORY_ALLOCATION_FREE
+#if USE_DEVICE_DEPENDENT_ERROR_INFORMATION && !USE_ERROR_INFO_POOL && !USE_MEMORY_ALLOCATION_FREE
 
 /**
  * Initialize context's
@@ -555,10 +585,10 @@ size_t SCPI_ResultError(scpi_t * context, scpi_error_t * error) {
 
 #if USE_DEVICE_DEPENDENT_ERROR_INFORMATION
     data[1] = error->device_dependent_info;
-#if USE_MEMORY_ALLOCATION_FREE
+#if USE_ERROR_INFO_POOL || USE_MEMORY_ALLOCATION_FREE
     len[1] = error->device_dependent_info ? strlen(data[1]) : 0;
 #else
-    SCPIDEFINE_get_parts(&context->error_info_heap, data[1], &len[1], &data[2], &len[2]);
+    SCPIDEFINE_get_parts(context, data[1], &len[1], &data[2], &len[2]);
 #endif
 #endif
 
@@ -600,13 +630,12 @@ size_t SCPI_ResultError(scpi_t * context, scpi_error_t * error) {
 }
 
 /**
- * Write arbitrary block header with length
- * @param context
- * @param len
- * @return
+ * Format arbitrary block header
+ * @param block_header buffer for at least 12 characters
+ * @param len length of block data
+ * @return length of the header
  */
-size_t SCPI_ResultArbitraryBlockHeader(scpi_t * context, size_t len) {
-    char block_header[12];
+static size_t formatArbitraryBlockHeader(char * block_header, size_t len) {
     size_t header_len;
     block_header[0] = '#';
     SCPI_UInt32ToStrBase((uint32_t) len, block_header + 2, 10, 10);
@@ -614,8 +643,21 @@ size_t SCPI_ResultArbitraryBlockHeader(scpi_t * context, size_t len) {
     header_len = strlen(block_header + 2);
     block_header[1] = (char) (header_len + '0');
 
+    return header_len + 2;
+}
+
+/**
+ * Write arbitrary block header with length
+ * @param context
+ * @param len
+ * @return
+ */
+size_t SCPI_ResultArbitraryBlockHeader(scpi_t * context, size_t len) {
+    char block_header[12];
+    size_t header_len = formatArbitraryBlockHeader(block_header, len);
+
     context->arbitrary_reminding = len;
-    return writeData(context, block_header, header_len + 2);
+    return writeData(context, block_header, header_len);
 }
 
 /**
@@ -642,7 +684,9 @@ size_t SCPI_ResultArbitraryBlockData(scpi_t * context, const void * data, size_t
 }
 
 /**
- * Write arbitrary block program data to the result
+ * Write arbitrary block program data to the result. If the interface has
+ * write_vector callback, header and data are passed in one call and data
+ * are not copied by the library.
  * @param context
  * @param data
  * @param len
@@ -650,6 +694,20 @@ size_t SCPI_ResultArbitraryBlockData(scpi_t * context, const void * data, size_t
  */
 size_t SCPI_ResultArbitraryBlock(scpi_t * context, const void * data, size_t len) {
     size_t result = 0;
+    char block_header[12];
+    scpi_iovec_t iov[2];
+
+    if (context->interface && context->interface->write_vector) {
+        iov[0].data = block_header;
+        iov[0].len = formatArbitraryBlockHeader(block_header, len);
+        iov[1].data = (const char *) data;
+        iov[1].len = len;
+
+        context->arbitrary_reminding = 0;
+        context->output_count++;
+        return context->interface->write_vector(context, iov, (len > 0) ? 2 : 1);
+    }
+
     result += SCPI_ResultArbitraryBlockHeader(context, len);
     result += SCPI_ResultArbitraryBlockData(context, data, len);
     return result;
@@ -1216,6 +1274,172 @@ scpi_bool_t SCPI_ParamCopyText(scpi_t * context, char * buffer, size_t buffer_le
     return result;
 }
 
+#if USE_CHOICE_INDEX
+#define CHOICE_INDEX_MASK (SCPI_CHOICE_INDEX_SIZE - 1)
+
+/**
+ * Hash of choice tag
+ * @param tag
+ * @return slot in index
+ */
+static size_t choiceTagSlot(int32_t tag) {
+    return (((uint32_t) tag * 2654435761u) >> 16) & CHOICE_INDEX_MASK;
+}
+
+/**
+ * Insert one form (long or short) of choice pattern to the index. Form is
+ * skipped if some previous choice already matches it, so the first matching
+ * choice wins as in linear search.
+ * @param index
+ * @param form text of the form
+ * @param len length of the form
+ * @param pos position of the choice in options
+ * @param used number of already used slots
+ * @return FALSE if the index is full
+ */
+static scpi_bool_t choiceIndexInsert(scpi_choice_index_t * index, const scpi_choice_def_t * options, const char * form, size_t len, size_t pos, size_t * used) {
+    size_t slot = hashStrCase(form, len) & CHOICE_INDEX_MASK;
+    const char * name;
+
+    while (index->names[slot] != 0) {
+        name = options[index->names[slot] - 1].name;
+        if (matchPattern(name, strlen(name), form, len, NULL)) {
+            return TRUE;
+        }
+        slot = (slot + 1) & CHOICE_INDEX_MASK;
+    }
+
+    if (*used >= SCPI_CHOICE_INDEX_SIZE / 2) {
+        return FALSE;
+    }
+
+    index->names[slot] = (uint8_t) (pos + 1);
+    (*used)++;
+    return TRUE;
+}
+
+/**
+ * Build hash index of choice list. Both long and short forms of each pattern
+ * are indexed for SCPI_ParamToChoice and the first name of each tag for
+ * SCPI_ChoiceToName. Lists with numeric suffix patterns (#) or too many
+ * names are not indexed.
+ * @param index index to initialize
+ * @param options NULL terminated list of choices
+ * @return TRUE if the index was built
+ */
+scpi_bool_t SCPI_ChoiceIndexInit(scpi_choice_index_t * index, const scpi_choice_def_t * options) {
+    size_t i;
+    size_t len;
+    size_t short_len;
+    size_t slot;
+    size_t used = 0;
+
+    if (!index) {
+        return FALSE;
+    }
+
+    memset(index, 0, sizeof (*index));
+
+    if (!options) {
+        return FALSE;
+    }
+
+    for (i = 0; options[i].name != NULL; i++) {
+        len = strlen(options[i].name);
+        if ((i >= 255) || (len == 0) || (options[i].name[len - 1] == '#')) {
+            memset(index, 0, sizeof (*index));
+            return FALSE;
+        }
+
+        for (short_len = 0; (short_len < len) && !islower((unsigned char) options[i].name[short_len]); short_len++) {
+        }
+
+        if (!choiceIndexInsert(index, options, options[i].name, len, i, &used) ||
+                !choiceIndexInsert(index, options, options[i].name, short_len, i, &used)) {
+            memset(index, 0, sizeof (*index));
+            return FALSE;
+        }
+
+        slot = choiceTagSlot(options[i].tag);
+        while ((index->tags[slot] != 0) && (options[index->tags[slot] - 1].tag != options[i].tag)) {
+            slot = (slot + 1) & CHOICE_INDEX_MASK;
+        }
+        if (index->tags[slot] == 0) {
+            index->tags[slot] = (uint8_t) (i + 1);
+        }
+    }
+
+    index->options = options;
+    return TRUE;
+}
+
+/**
+ * Register choice index in context, so it is used by every lookup
+ * in its choice list. Index must stay valid for the life of the context.
+ * @param context
+ * @param index index built by SCPI_ChoiceIndexInit
+ * @return FALSE if there is no free registration slot
+ */
+scpi_bool_t SCPI_ChoiceIndexRegister(scpi_t * context, const scpi_choice_index_t * index) {
+    size_t i;
+
+    if (!index || !index->options) {
+        return FALSE;
+    }
+
+    for (i = 0; i < SCPI_CHOICE_INDEX_COUNT; i++) {
+        if ((context->choice_index[i] == NULL) || (context->choice_index[i]->options == index->options)) {
+            context->choice_index[i] = index;
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/**
+ * Remove choice index from context, lookups in its choice list fall back
+ * to linear search.
+ * @param context
+ * @param index index registered by SCPI_ChoiceIndexRegister
+ * @return FALSE if the index was not registered
+ */
+scpi_bool_t SCPI_ChoiceIndexUnregister(scpi_t * context, const scpi_choice_index_t * index) {
+    size_t i;
+
+    for (i = 0; (i < SCPI_CHOICE_INDEX_COUNT) && context->choice_index[i]; i++) {
+        if (context->choice_index[i] == index) {
+            /* keep registered indexes contiguous, lookup stops at the first empty slot */
+            for (; (i + 1 < SCPI_CHOICE_INDEX_COUNT) && context->choice_index[i + 1]; i++) {
+                context->choice_index[i] = context->choice_index[i + 1];
+            }
+            context->choice_index[i] = NULL;
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/**
+ * Find registered index of choice list
+ * @param context
+ * @param options
+ * @return index or NULL
+ */
+static const scpi_choice_index_t * findChoiceIndex(scpi_t * context, const scpi_choice_def_t * options) {
+    size_t i;
+
+    for (i = 0; (i < SCPI_CHOICE_INDEX_COUNT) && context->choice_index[i]; i++) {
+        if (context->choice_index[i]->options == options) {
+            return context->choice_index[i];
+        }
+    }
+
+    return NULL;
+}
+#endif
+
 /**
  * Convert parameter to choice
  * @param context
@@ -1227,6 +1451,10 @@ scpi_bool_t SCPI_ParamCopyText(scpi_t * context, char * buffer, size_t buffer_le
 scpi_bool_t SCPI_ParamToChoice(scpi_t * context, scpi_parameter_t * parameter, const scpi_choice_def_t * options, int32_t * value) {
     size_t res;
     scpi_bool_t result = FALSE;
+#if USE_CHOICE_INDEX
+    const scpi_choice_index_t * index;
+    size_t slot;
+#endif
 
     if (!options || !value) {
         SCPI_ErrorPush(context, SCPI_ERROR_SYSTEM_ERROR);
@@ -1234,11 +1462,28 @@ scpi_bool_t SCPI_ParamToChoice(scpi_t * context, scpi_parameter_t * parameter, c
     }
 
     if (parameter->type == SCPI_TOKEN_PROGRAM_MNEMONIC) {
-        for (res = 0; options[res].name; ++res) {
-            if (matchPattern(options[res].name, strlen(options[res].name), parameter->ptr, parameter->len, NULL)) {
-                *value = options[res].tag;
-                result = TRUE;
-                break;
+#if USE_CHOICE_INDEX
+        index = findChoiceIndex(context, options);
+        if (index) {
+            slot = hashStrCase(parameter->ptr, parameter->len) & CHOICE_INDEX_MASK;
+            while (index->names[slot] != 0) {
+                res = index->names[slot] - 1;
+                if (matchPattern(options[res].name, strlen(options[res].name), parameter->ptr, parameter->len, NULL)) {
+                    *value = options[res].tag;
+                    result = TRUE;
+                    break;
+                }
+                slot = (slot + 1) & CHOICE_INDEX_MASK;
+            }
+        } else
+#endif
+        {
+            for (res = 0; options[res].name; ++res) {
+                if (matchPattern(options[res].name, strlen(options[res].name), parameter->ptr, parameter->len, NULL)) {
+                    *value = options[res].tag;
+                    result = TRUE;
+                    break;
+                }
             }
         }
 
@@ -1272,6 +1517,37 @@ scpi_bool_t SCPI_ChoiceToName(const scpi_choice_def_t * options, int32_t tag, co
     return FALSE;
 }
 
+/**
+ * Same as SCPI_ChoiceToName, but uses choice index registered in context
+ * @param context
+ * @param options specifications of choices numbers (patterns)
+ * @param tag numerical representatio of choice
+ * @param text result text
+ * @return TRUE if succesfule, else FALSE
+ */
+scpi_bool_t SCPI_ChoiceToNameIndexed(scpi_t * context, const scpi_choice_def_t * options, int32_t tag, const char ** text) {
+#if USE_CHOICE_INDEX
+    const scpi_choice_index_t * index = findChoiceIndex(context, options);
+    size_t slot;
+
+    if (index) {
+        slot = choiceTagSlot(tag);
+        while (index->tags[slot] != 0) {
+            if (options[index->tags[slot] - 1].tag == tag) {
+                *text = options[index->tags[slot] - 1].name;
+                return TRUE;
+            }
+            slot = (slot + 1) & CHOICE_INDEX_MASK;
+        }
+        return FALSE;
+    }
+#else
+    (void) context;
+#endif
+
+    return SCPI_ChoiceToName(options, tag, text);
+}
+
 /*
  * Definition of BOOL choice list
  */
@@ -1579,28 +1855,19 @@ static size_t produceResultArrayBinary(scpi_t * context, const void * array, siz
                 return 0;
         }
 
-        switch (item_size) {
-            case 1:
-                result += SCPI_ResultArbitraryBlockData(context, array, count);
-                break;
-            case 2:
-                for (i = 0; i < count; i++) {
-                    uint16_t val = SCPI_Swap16(((uint16_t*) array)[i]);
-                    result += SCPI_ResultArbitraryBlockData(context, &val, item_size);
-                }
-                break;
-            case 4:
-                for (i = 0; i < count; i++) {
-                    uint32_t val = SCPI_Swap32(((uint32_t*) array)[i]);
-                    result += SCPI_ResultArbitraryBlockData(context, &val, item_size);
-                }
-                break;
-            case 8:
-                for (i = 0; i < count; i++) {
-                    uint64_t val = SCPI_Swap64(((uint64_t*) array)[i]);
-                    result += SCPI_ResultArbitraryBlockData(context, &val, item_size);
-                }
-                break;
+        if (item_size == 1) {
+            result += SCPI_ResultArbitraryBlockData(context, array, count);
+        } else {
+            /* swap to staging buffer and write it in large chunks instead of item by item */
+            uint64_t staging[SCPI_RESULT_ARRAY_STAGING_LENGTH / sizeof (uint64_t)];
+            size_t chunk = sizeof (staging) / item_size;
+            size_t n;
+
+            for (i = 0; i < count; i += n) {
+                n = min(chunk, count - i);
+                swapArray(staging, (const uint8_t *) array + i * item_size, n, item_size);
+                result += SCPI_ResultArbitraryBlockData(context, staging, n * item_size);
+            }
         }
 
         return result;
@@ -1608,13 +1875,183 @@ static size_t produceResultArrayBinary(scpi_t * context, const void * array, siz
 }
 
 
+/* Space for one ASCII array element, same as buffer in SCPI_ResultDouble */
+#define RESULT_ARRAY_ITEM_LENGTH 32
+
+#if SCPI_RESULT_ARRAY_STAGING_LENGTH < (RESULT_ARRAY_ITEM_LENGTH + 1)
+#error SCPI_RESULT_ARRAY_STAGING_LENGTH is too small for ASCII array element
+#endif
+
+/**
+ * Formatter of one ASCII array element
+ * @param item pointer to array element
+ * @param buffer output buffer
+ * @param len length of buffer
+ * @return number of characters written (without '\0')
+ */
+typedef size_t(*result_array_format_t)(const void * item, char * buffer, size_t len);
+
+/*
+ * Template macro to generate element formatters for produceResultArrayAscii.
+ * Each one gives the same text as corresponding SCPI_ResultXYZ function
+ */
+#define RESULT_ARRAY_FORMAT(name, type, expr) \
+static size_t name(const void * item, char * buffer, size_t len) {\
+    type val = *(const type *) item;\
+    return expr;\
+}
+
+RESULT_ARRAY_FORMAT(formatArrayInt8, int8_t, UInt32ToStrBaseSign((int32_t) val, buffer, len, 10, TRUE))
+RESULT_ARRAY_FORMAT(formatArrayUInt8, uint8_t, UInt32ToStrBaseSign(val, buffer, len, 10, FALSE))
+RESULT_ARRAY_FORMAT(formatArrayInt16, int16_t, UInt32ToStrBaseSign((int32_t) val, buffer, len, 10, TRUE))
+RESULT_ARRAY_FORMAT(formatArrayUInt16, uint16_t, UInt32ToStrBaseSign(val, buffer, len, 10, FALSE))
+RESULT_ARRAY_FORMAT(formatArrayInt32, int32_t, UInt32ToStrBaseSign(val, buffer, len, 10, TRUE))
+RESULT_ARRAY_FORMAT(formatArrayUInt32, uint32_t, UInt32ToStrBaseSign(val, buffer, len, 10, FALSE))
+RESULT_ARRAY_FORMAT(formatArrayInt64, int64_t, UInt64ToStrBaseSign(val, buffer, len, 10, TRUE))
+RESULT_ARRAY_FORMAT(formatArrayUInt64, uint64_t, UInt64ToStrBaseSign(val, buffer, len, 10, FALSE))
+RESULT_ARRAY_FORMAT(formatArrayFloat, float, SCPI_FloatToStr(val, buffer, len))
+RESULT_ARRAY_FORMAT(formatArrayDouble, double, SCPI_DoubleToStr(val, buffer, len))
+
+/**
+ * Result ASCII array. Elements with delimiters are formatted to staging
+ * buffer which is written in large chunks instead of two writes per element.
+ * Output is the same as calling SCPI_ResultXYZ for each element.
+ * @param context
+ * @param array
+ * @param count
+ * @param item_size
+ * @param format element formatter
+ * @return
+ */
+static size_t produceResultArrayAscii(scpi_t * context, const void * array, size_t count, size_t item_size, result_array_format_t format) {
+    char staging[SCPI_RESULT_ARRAY_STAGING_LENGTH];
+    size_t result = 0;
+    size_t pos = 0;
+    size_t i;
+
+    for (i = 0; i < count; i++) {
+        if (sizeof (staging) - pos < RESULT_ARRAY_ITEM_LENGTH + 1) {
+            result += writeData(context, staging, pos);
+            pos = 0;
+        }
+        if (context->output_count > 0) {
+            staging[pos++] = ',';
+        }
+        pos += format((const uint8_t *) array + i * item_size, staging + pos, RESULT_ARRAY_ITEM_LENGTH);
+        context->output_count++;
+    }
+    result += writeData(context, staging, pos);
+
+    return result;
+}
+
+#if USE_PARALLEL_ARRAY_FORMAT
+
+/**
+ * Chunk of ASCII array formatted by worker thread
+ */
+struct _result_array_chunk_t {
+    const uint8_t * items;
+    size_t count;
+    size_t item_size;
+    result_array_format_t format;
+    char * buffer;
+    size_t len;
+    pthread_t thread;
+    scpi_bool_t running;
+};
+typedef struct _result_array_chunk_t result_array_chunk_t;
+
+/**
+ * Worker thread formatting chunk of ASCII array to its buffer. Chunk always
+ * follows preceding one, so each element starts with delimiter.
+ * @param arg chunk
+ * @return NULL
+ */
+static void * formatArrayChunk(void * arg) {
+    result_array_chunk_t * chunk = (result_array_chunk_t *) arg;
+    size_t pos = 0;
+    size_t i;
+
+    for (i = 0; i < chunk->count; i++) {
+        chunk->buffer[pos++] = ',';
+        pos += chunk->format(chunk->items + i * chunk->item_size, chunk->buffer + pos, RESULT_ARRAY_ITEM_LENGTH);
+    }
+    chunk->len = pos;
+
+    return NULL;
+}
+
+/**
+ * Result ASCII array formatted in parallel. Array is split into chunks of at
+ * least SCPI_PARALLEL_ARRAY_FORMAT_CHUNK elements. First chunk is formatted
+ * serially by calling thread while other chunks are formatted by worker
+ * threads, then written in order. Chunk without buffer or thread falls back
+ * to serial formatting, so output is always the same as of
+ * produceResultArrayAscii.
+ * @param context
+ * @param array
+ * @param count
+ * @param item_size
+ * @param format element formatter
+ * @return
+ */
+static size_t produceResultArrayAsciiParallel(scpi_t * context, const void * array, size_t count, size_t item_size, result_array_format_t format) {
+    result_array_chunk_t chunks[SCPI_PARALLEL_ARRAY_FORMAT_THREADS];
+    size_t chunk_count = count / SCPI_PARALLEL_ARRAY_FORMAT_CHUNK;
+    size_t start = 0;
+    size_t result = 0;
+    size_t i;
+
+    if (chunk_count < 2) {
+        return produceResultArrayAscii(context, array, count, item_size, format);
+    }
+    if (chunk_count > SCPI_PARALLEL_ARRAY_FORMAT_THREADS) {
+        chunk_count = SCPI_PARALLEL_ARRAY_FORMAT_THREADS;
+    }
+
+    for (i = 0; i < chunk_count; i++) {
+        result_array_chunk_t * chunk = &chunks[i];
+
+        chunk->items = (const uint8_t *) array + start * item_size;
+        chunk->count = count / chunk_count + ((i < count % chunk_count) ? 1 : 0);
+        chunk->item_size = item_size;
+        chunk->format = format;
+        chunk->buffer = NULL;
+        chunk->len = 0;
+        chunk->running = FALSE;
+        if (i > 0) {
+            chunk->buffer = (char *) malloc(chunk->count * (RESULT_ARRAY_ITEM_LENGTH + 1));
+            chunk->running = chunk->buffer && (pthread_create(&chunk->thread, NULL, formatArrayChunk, chunk) == 0);
+        }
+        start += chunk->count;
+    }
+
+    for (i = 0; i < chunk_count; i++) {
+        result_array_chunk_t * chunk = &chunks[i];
+
+        if (chunk->running) {
+            pthread_join(chunk->thread, NULL);
+            result += writeData(context, chunk->buffer, chunk->len);
+            context->output_count += (int_fast16_t) chunk->count;
+        } else {
+            result += produceResultArrayAscii(context, chunk->items, chunk->count, item_size, format);
+        }
+        free(chunk->buffer);
+    }
+
+    return result;
+}
+
+#define PRODUCE_RESULT_ARRAY_ASCII produceResultArrayAsciiParallel
+#else
+#define PRODUCE_RESULT_ARRAY_ASCII produceResultArrayAscii
+#endif
+
 #define RESULT_ARRAY(func) do {\
     size_t result = 0;\
     if (format == SCPI_FORMAT_ASCII) {\
-        size_t i;\
-        for (i = 0; i < count; i++) {\
-            result += func(context, array[i]);\
-        }\
+        result = PRODUCE_RESULT_ARRAY_ASCII(context, array, count, sizeof(*array), func);\
     } else {\
         result = produceResultArrayBinary(context, array, count, sizeof(*array), format);\
     }\
@@ -1630,7 +2067,7 @@ static size_t produceResultArrayBinary(scpi_t * context, const void * array, siz
  * @return
  */
 size_t SCPI_ResultArrayInt8(scpi_t * context, const int8_t * array, size_t count, scpi_array_format_t format) {
-    RESULT_ARRAY(SCPI_ResultInt8);
+    RESULT_ARRAY(formatArrayInt8);
 }
 
 /**
@@ -1642,7 +2079,7 @@ size_t SCPI_ResultArrayInt8(scpi_t * context, const int8_t * array, size_t count
  * @return
  */
 size_t SCPI_ResultArrayUInt8(scpi_t * context, const uint8_t * array, size_t count, scpi_array_format_t format) {
-    RESULT_ARRAY(SCPI_ResultUInt8);
+    RESULT_ARRAY(formatArrayUInt8);
 }
 
 /**
@@ -1654,7 +2091,7 @@ size_t SCPI_ResultArrayUInt8(scpi_t * context, const uint8_t * array, size_t cou
  * @return
  */
 size_t SCPI_ResultArrayInt16(scpi_t * context, const int16_t * array, size_t count, scpi_array_format_t format) {
-    RESULT_ARRAY(SCPI_ResultInt16);
+    RESULT_ARRAY(formatArrayInt16);
 }
 
 /**
@@ -1666,7 +2103,7 @@ size_t SCPI_ResultArrayInt16(scpi_t * context, const int16_t * array, size_t cou
  * @return
  */
 size_t SCPI_ResultArrayUInt16(scpi_t * context, const uint16_t * array, size_t count, scpi_array_format_t format) {
-    RESULT_ARRAY(SCPI_ResultUInt16);
+    RESULT_ARRAY(formatArrayUInt16);
 }
 
 /**
@@ -1678,7 +2115,7 @@ size_t SCPI_ResultArrayUInt16(scpi_t * context, const uint16_t * array, size_t c
  * @return
  */
 size_t SCPI_ResultArrayInt32(scpi_t * context, const int32_t * array, size_t count, scpi_array_format_t format) {
-    RESULT_ARRAY(SCPI_ResultInt32);
+    RESULT_ARRAY(formatArrayInt32);
 }
 
 /**
@@ -1690,7 +2127,7 @@ size_t SCPI_ResultArrayInt32(scpi_t * context, const int32_t * array, size_t cou
  * @return
  */
 size_t SCPI_ResultArrayUInt32(scpi_t * context, const uint32_t * array, size_t count, scpi_array_format_t format) {
-    RESULT_ARRAY(SCPI_ResultUInt32);
+    RESULT_ARRAY(formatArrayUInt32);
 }
 
 /**
@@ -1702,7 +2139,7 @@ size_t SCPI_ResultArrayUInt32(scpi_t * context, const uint32_t * array, size_t c
  * @return
  */
 size_t SCPI_ResultArrayInt64(scpi_t * context, const int64_t * array, size_t count, scpi_array_format_t format) {
-    RESULT_ARRAY(SCPI_ResultInt64);
+    RESULT_ARRAY(formatArrayInt64);
 }
 
 /**
@@ -1714,7 +2151,7 @@ size_t SCPI_ResultArrayInt64(scpi_t * context, const int64_t * array, size_t cou
  * @return
  */
 size_t SCPI_ResultArrayUInt64(scpi_t * context, const uint64_t * array, size_t count, scpi_array_format_t format) {
-    RESULT_ARRAY(SCPI_ResultUInt64);
+    RESULT_ARRAY(formatArrayUInt64);
 }
 
 /**
@@ -1726,7 +2163,7 @@ size_t SCPI_ResultArrayUInt64(scpi_t * context, const uint64_t * array, size_t c
  * @return
  */
 size_t SCPI_ResultArrayFloat(scpi_t * context, const float * array, size_t count, scpi_array_format_t format) {
-    RESULT_ARRAY(SCPI_ResultFloat);
+    RESULT_ARRAY(formatArrayFloat);
 }
 
 /**
@@ -1738,16 +2175,223 @@ size_t SCPI_ResultArrayFloat(scpi_t * context, const float * array, size_t count
  * @return
  */
 size_t SCPI_ResultArrayDouble(scpi_t * context, const double * array, size_t count, scpi_array_format_t format) {
-    RESULT_ARRAY(SCPI_ResultDouble);
+    RESULT_ARRAY(formatArrayDouble);
+}
+
+/**
+ * Read next array element directly from the lexer buffer if it is a plain
+ * decimal number "[+-]digits[.digits]" surrounded by optional whitespace and
+ * followed by comma or end of data. Anything else (other radix, exponent,
+ * suffix, too many digits, ...) is left to the generic SCPI_Parameter path,
+ * so the result is always the same as the generic path would give.
+ * @param context
+ * @param allow_sign accept leading sign
+ * @param max_digits maximum number of digits (integer and fraction part)
+ * @param max_fraction maximum number of fraction digits
+ * @param mantissa all digits as integer
+ * @param fraction number of fraction digits
+ * @param negative TRUE if there was minus sign
+ * @return TRUE if element was read and lexer moved behind it
+ */
+static scpi_bool_t paramArrayFastDecimal(scpi_t * context, scpi_bool_t allow_sign, int max_digits, int max_fraction, uint64_t * mantissa, int * fraction, scpi_bool_t * negative) {
+    lex_state_t * state = &context->param_list.lex_state;
+    const char * p = state->pos;
+    const char * end = state->buffer + state->len;
+    uint64_t value = 0;
+    int digits = 0;
+    int frac = -1;
+
+    if (p >= end) {
+        return FALSE;
+    }
+
+    if (context->input_count != 0) {
+        if (*p != ',') {
+            return FALSE;
+        }
+        p++;
+    }
+
+    while ((p < end) && ((*p == ' ') || (*p == '\t'))) {
+        p++;
+    }
+
+    *negative = FALSE;
+    if ((p < end) && allow_sign && ((*p == '+') || (*p == '-'))) {
+        *negative = (*p == '-') ? TRUE : FALSE;
+        p++;
+    }
+
+    for (; p < end; p++) {
+        if ((*p >= '0') && (*p <= '9')) {
+            if (++digits > max_digits) {
+                return FALSE;
+            }
+            value = value * 10 + (uint64_t) (*p - '0');
+            if (frac >= 0) {
+                frac++;
+            }
+        } else if ((*p == '.') && (frac < 0) && (max_fraction > 0) && (digits > 0)) {
+            frac = 0;
+        } else {
+            break;
+        }
+    }
+
+    if ((digits == 0) || (frac == 0) || (frac > max_fraction)) {
+        return FALSE;
+    }
+
+    while ((p < end) && ((*p == ' ') || (*p == '\t'))) {
+        p++;
+    }
+
+    if ((p < end) && (*p != ',')) {
+        return FALSE;
+    }
+
+    state->pos = (char *) p;
+    context->input_count++;
+    *mantissa = value;
+    *fraction = (frac < 0) ? 0 : frac;
+    return TRUE;
 }
 
+/**
+ * Fast path of SCPI_ParamArrayInt32 for up to 9 digit integers
+ * @param context
+ * @param value result
+ * @return TRUE if element was read
+ */
+static scpi_bool_t paramArrayFastInt32(scpi_t * context, int32_t * value) {
+    uint64_t mantissa;
+    int fraction;
+    scpi_bool_t negative;
+
+    if (!paramArrayFastDecimal(context, TRUE, 9, 0, &mantissa, &fraction, &negative)) {
+        return FALSE;
+    }
+    *value = negative ? -(int32_t) mantissa : (int32_t) mantissa;
+    return TRUE;
+}
+
+/**
+ * Fast path of SCPI_ParamArrayUInt32 for up to 9 digit integers
+ * @param context
+ * @param value result
+ * @return TRUE if element was read
+ */
+static scpi_bool_t paramArrayFastUInt32(scpi_t * context, uint32_t * value) {
+    uint64_t mantissa;
+    int fraction;
+    scpi_bool_t negative;
+
+    if (!paramArrayFastDecimal(context, FALSE, 9, 0, &mantissa, &fraction, &negative)) {
+        return FALSE;
+    }
+    *value = (uint32_t) mantissa;
+    return TRUE;
+}
+
+/**
+ * Fast path of SCPI_ParamArrayInt64 for up to 18 digit integers
+ * @param context
+ * @param value result
+ * @return TRUE if element was read
+ */
+static scpi_bool_t paramArrayFastInt64(scpi_t * context, int64_t * value) {
+    uint64_t mantissa;
+    int fraction;
+    scpi_bool_t negative;
+
+    if (!paramArrayFastDecimal(context, TRUE, 18, 0, &mantissa, &fraction, &negative)) {
+        return FALSE;
+    }
+    *value = negative ? -(int64_t) mantissa : (int64_t) mantissa;
+    return TRUE;
+}
+
+/**
+ * Fast path of SCPI_ParamArrayUInt64 for up to 18 digit integers
+ * @param context
+ * @param value result
+ * @return TRUE if element was read
+ */
+static scpi_bool_t paramArrayFastUInt64(scpi_t * context, uint64_t * value) {
+    uint64_t mantissa;
+    int fraction;
+    scpi_bool_t negative;
+
+    if (!paramArrayFastDecimal(context, FALSE, 18, 0, &mantissa, &fraction, &negative)) {
+        return FALSE;
+    }
+    *value = mantissa;
+    return TRUE;
+}
+
+/*
+ * Mantissa and power of ten are both exactly representable, so one correctly
+ * rounded division gives the same value as strtof/strtod. This holds only
+ * if floating point expressions are evaluated in their own precision.
+ */
+#if defined(FLT_EVAL_METHOD) && (FLT_EVAL_METHOD == 0)
+static const double paramArrayPow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+/**
+ * Fast path of SCPI_ParamArrayFloat for up to 7 significant digits
+ * @param context
+ * @param value result
+ * @return TRUE if element was read
+ */
+static scpi_bool_t paramArrayFastFloat(scpi_t * context, float * value) {
+    uint64_t mantissa;
+    int fraction;
+    scpi_bool_t negative;
+    float result;
+
+    if (!paramArrayFastDecimal(context, TRUE, 7, 10, &mantissa, &fraction, &negative)) {
+        return FALSE;
+    }
+    result = (float) mantissa / (float) paramArrayPow10[fraction];
+    *value = negative ? -result : result;
+    return TRUE;
+}
+
+/**
+ * Fast path of SCPI_ParamArrayDouble for up to 15 significant digits
+ * @param context
+ * @param value result
+ * @return TRUE if element was read
+ */
+static scpi_bool_t paramArrayFastDouble(scpi_t * context, double * value) {
+    uint64_t mantissa;
+    int fraction;
+    scpi_bool_t negative;
+    double result;
+
+    if (!paramArrayFastDecimal(context, TRUE, 15, 22, &mantissa, &fraction, &negative)) {
+        return FALSE;
+    }
+    result = (double) mantissa / paramArrayPow10[fraction];
+    *value = negative ? -result : result;
+    return TRUE;
+}
+#else
+#define paramArrayFastFloat(context, value) FALSE
+#define paramArrayFastDouble(context, value) FALSE
+#endif
+
 /*
  * Template macro to generate all SCPI_ParamArrayXYZ function
+ * Plain decimal elements are decoded by fast function, others by func
  */
-#define PARAM_ARRAY_TEMPLATE(func) do{\
+#define PARAM_ARRAY_TEMPLATE(fast, func) do{\
     if (format != SCPI_FORMAT_ASCII) return FALSE;\
     for (*o_count = 0; *o_count < i_count; (*o_count)++) {\
-        if (!func(context, &data[*o_count], mandatory)) {\
+        if (!fast(context, &data[*o_count]) && !func(context, &data[*o_count], mandatory)) {\
             break;\
         }\
         mandatory = FALSE;\
@@ -1765,7 +2409,7 @@ size_t SCPI_ResultArrayDouble(scpi_t * context, const double * array, size_t cou
  * @return TRUE on success
  */
 scpi_bool_t SCPI_ParamArrayInt32(scpi_t * context, int32_t *data, size_t i_count, size_t *o_count, scpi_array_format_t format, scpi_bool_t mandatory) {
-    PARAM_ARRAY_TEMPLATE(SCPI_ParamInt32);
+    PARAM_ARRAY_TEMPLATE(paramArrayFastInt32, SCPI_ParamInt32);
 }
 
 /**
@@ -1778,7 +2422,7 @@ scpi_bool_t SCPI_ParamArrayInt32(scpi_t * context, int32_t *data, size_t i_count
  * @return TRUE on success
  */
 scpi_bool_t SCPI_ParamArrayUInt32(scpi_t * context, uint32_t *data, size_t i_count, size_t *o_count, scpi_array_format_t format, scpi_bool_t mandatory) {
-    PARAM_ARRAY_TEMPLATE(SCPI_ParamUInt32);
+    PARAM_ARRAY_TEMPLATE(paramArrayFastUInt32, SCPI_ParamUInt32);
 }
 
 /**
@@ -1791,7 +2435,7 @@ scpi_bool_t SCPI_ParamArrayUInt32(scpi_t * context, uint32_t *data, size_t i_cou
  * @return TRUE on success
  */
 scpi_bool_t SCPI_ParamArrayInt64(scpi_t * context, int64_t *data, size_t i_count, size_t *o_count, scpi_array_format_t format, scpi_bool_t mandatory) {
-    PARAM_ARRAY_TEMPLATE(SCPI_ParamInt64);
+    PARAM_ARRAY_TEMPLATE(paramArrayFastInt64, SCPI_ParamInt64);
 }
 
 /**
@@ -1804,7 +2448,7 @@ scpi_bool_t SCPI_ParamArrayInt64(scpi_t * context, int64_t *data, size_t i_count
  * @return TRUE on success
  */
 scpi_bool_t SCPI_ParamArrayUInt64(scpi_t * context, uint64_t *data, size_t i_count, size_t *o_count, scpi_array_format_t format, scpi_bool_t mandatory) {
-    PARAM_ARRAY_TEMPLATE(SCPI_ParamUInt64);
+    PARAM_ARRAY_TEMPLATE(paramArrayFastUInt64, SCPI_ParamUInt64);
 }
 
 /**
@@ -1817,7 +2461,7 @@ scpi_bool_t SCPI_ParamArrayUInt64(scpi_t * context, uint64_t *data, size_t i_cou
  * @return TRUE on success
  */
 scpi_bool_t SCPI_ParamArrayFloat(scpi_t * context, float *data, size_t i_count, size_t *o_count, scpi_array_format_t format, scpi_bool_t mandatory) {
-    PARAM_ARRAY_TEMPLATE(SCPI_ParamFloat);
+    PARAM_ARRAY_TEMPLATE(paramArrayFastFloat, SCPI_ParamFloat);
 }
 
 /**
@@ -1830,5 +2474,5 @@ scpi_bool_t SCPI_ParamArrayFloat(scpi_t * context, float *data, size_t i_count,
  * @return TRUE on success
  */
 scpi_bool_t SCPI_ParamArrayDouble(scpi_t * context, double *data, size_t i_count, size_t *o_count, scpi_array_format_t format, scpi_bool_t mandatory) {
-    PARAM_ARRAY_TEMPLATE(SCPI_ParamDouble);
+    PARAM_ARRAY_TEMPLATE(paramArrayFastDouble, SCPI_ParamDouble);
 }
@@ -38,6 +38,7 @@
 #include <string.h>
 #include "parser.h"
 #include "units.h"
+#include "units_private.h"
 #include "utils_private.h"
 #include "utils.h"
 #include "error.h"
@@ -286,20 +287,76 @@ const scpi_choice_def_t scpi_special_numbers_def[] = {
     SCPI_CHOICE_LIST_END,
 };
 
+#if USE_UNITS_INDEX
+/**
+ * Build hash index of units table
+ *  - names is open addressing hash table of (index + 1) of units, 0 is free slot
+ *  - base is (index + 1) of first unit with multiplier 1 for each scpi_unit_t
+ * Index is left empty (and linear search is used) if the table is too large.
+ * @param index index to initialize
+ * @param units units definitions
+ */
+void scpiUnits_initIndex(scpi_units_index_t * index, const scpi_unit_def_t * units) {
+    size_t i;
+    size_t slot;
+
+    memset(index, 0, sizeof (*index));
+
+    if (units == NULL) {
+        return;
+    }
+
+    for (i = 0; units[i].name != NULL; i++) {
+        if (i >= SCPI_UNITS_INDEX_SIZE / 2) {
+            return;
+        }
+    }
+
+    for (i = 0; units[i].name != NULL; i++) {
+        slot = hashStrCase(units[i].name, strlen(units[i].name)) & (SCPI_UNITS_INDEX_SIZE - 1);
+        while (index->names[slot] != 0) {
+            slot = (slot + 1) & (SCPI_UNITS_INDEX_SIZE - 1);
+        }
+        index->names[slot] = (uint8_t) (i + 1);
+
+        if ((units[i].unit < SCPI_UNIT_COUNT) && (units[i].mult == 1) && (index->base[units[i].unit] == 0)) {
+            index->base[units[i].unit] = (uint8_t) (i + 1);
+        }
+    }
+
+    index->units = units;
+}
+#endif
+
 /**
  * Convert string describing unit to its representation
- * @param units units patterns
+ * @param context
  * @param unit text representation of unknown unit
  * @param len length of text representation
  * @return pointer of related unit definition or NULL
  */
-static const scpi_unit_def_t * translateUnit(const scpi_unit_def_t * units, const char * unit, size_t len) {
+static const scpi_unit_def_t * translateUnit(scpi_t * context, const char * unit, size_t len) {
+    const scpi_unit_def_t * units = context->units;
     int i;
 
     if (units == NULL) {
         return NULL;
     }
 
+#if USE_UNITS_INDEX
+    if (context->units_index.units == units) {
+        size_t slot = hashStrCase(unit, len) & (SCPI_UNITS_INDEX_SIZE - 1);
+        while (context->units_index.names[slot] != 0) {
+            i = context->units_index.names[slot] - 1;
+            if (compareStr(unit, len, units[i].name, strlen(units[i].name))) {
+                return &units[i];
+            }
+            slot = (slot + 1) & (SCPI_UNITS_INDEX_SIZE - 1);
+        }
+        return NULL;
+    }
+#endif
+
     for (i = 0; units[i].name != NULL; i++) {
         if (compareStr(unit, len, units[i].name, strlen(units[i].name))) {
             return &units[i];
@@ -311,17 +368,27 @@ static const scpi_unit_def_t * translateUnit(const scpi_unit_def_t * units, cons
 
 /**
  * Convert unit definition to string
- * @param units units definitions (patterns)
+ * @param context
  * @param unit type of unit
  * @return string representation of unit
  */
-static const char * translateUnitInverse(const scpi_unit_def_t * units, const scpi_unit_t unit) {
+static const char * translateUnitInverse(scpi_t * context, const scpi_unit_t unit) {
+    const scpi_unit_def_t * units = context->units;
     int i;
 
     if (units == NULL) {
         return NULL;
     }
 
+#if USE_UNITS_INDEX
+    if (context->units_index.units == units) {
+        if ((unit < SCPI_UNIT_COUNT) && (context->units_index.base[unit] != 0)) {
+            return units[context->units_index.base[unit] - 1].name;
+        }
+        return NULL;
+    }
+#endif
+
     for (i = 0; units[i].name != NULL; i++) {
         if ((units[i].unit == unit) && (units[i].mult == 1)) {
             return units[i].name;
@@ -332,36 +399,83 @@ static const char * translateUnitInverse(const scpi_unit_def_t * units, const sc
 }
 
 /**
- * Transform number to base units
+ * Translate numeric suffix to unit definition
  * @param context
  * @param unit text representation of unit
  * @param len length of text representation
- * @param value preparsed numeric value
- * @return TRUE if value parameter was converted to base units
+ * @param unitDef unit definition or NULL if there is no unit
+ * @return FALSE if the suffix is not a known unit
  */
-static scpi_bool_t transformNumber(scpi_t * context, const char * unit, size_t len, scpi_number_t * value) {
+static scpi_bool_t translateSuffix(scpi_t * context, const char * unit, size_t len, const scpi_unit_def_t ** unitDef) {
     size_t s;
-    const scpi_unit_def_t * unitDef;
     s = skipWhitespace(unit, len);
 
     if (s == len) {
-        value->unit = SCPI_UNIT_NONE;
+        *unitDef = NULL;
         return TRUE;
     }
 
-    unitDef = translateUnit(context->units, unit + s, len - s);
+    *unitDef = translateUnit(context, unit + s, len - s);
 
-    if (unitDef == NULL) {
+    if (*unitDef == NULL) {
         SCPI_ErrorPush(context, SCPI_ERROR_INVALID_SUFFIX);
         return FALSE;
     }
 
+    return TRUE;
+}
+
+/**
+ * Transform number to base units
+ * @param context
+ * @param unit text representation of unit
+ * @param len length of text representation
+ * @param value preparsed numeric value
+ * @return TRUE if value parameter was converted to base units
+ */
+static scpi_bool_t transformNumber(scpi_t * context, const char * unit, size_t len, scpi_number_t * value) {
+    const scpi_unit_def_t * unitDef;
+
+    if (!translateSuffix(context, unit, len, &unitDef)) {
+        return FALSE;
+    }
+
+    if (unitDef == NULL) {
+        value->unit = SCPI_UNIT_NONE;
+        return TRUE;
+    }
+
     value->content.value *= unitDef->mult;
     value->unit = unitDef->unit;
 
     return TRUE;
 }
 
+/**
+ * Find decimal exponent of unit multiplier
+ * @param mult unit multiplier
+ * @param exponent decimal exponent of the multiplier
+ * @return TRUE if the multiplier is an exact power of ten
+ */
+static scpi_bool_t unitMultToExponent(double mult, int32_t * exponent) {
+    static const double powers[] = {
+        1e-18, 1e-17, 1e-16, 1e-15, 1e-14, 1e-13, 1e-12, 1e-11, 1e-10,
+        1e-9, 1e-8, 1e-7, 1e-6, 1e-5, 1e-4, 1e-3, 1e-2, 1e-1,
+        1, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9,
+        1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18,
+    };
+    size_t i;
+
+    for (i = 0; i < sizeof (powers) / sizeof (powers[0]); i++) {
+        if (powers[i] == mult) {
+            *exponent = (int32_t) i - 18;
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
 /**
  * Parse parameter as number, number with unit or special value (min, max, default, ...)
  * @param context
@@ -465,6 +579,116 @@ scpi_bool_t SCPI_ParamNumber(scpi_t * context, const scpi_choice_def_t * special
     return result;
 }
 
+/**
+ * Parse parameter as fixed point number, number with unit or special value
+ * (min, max, default, ...). Decimal numbers with units, whose multiplier is
+ * a power of ten, are converted exactly without use of floating point, so
+ * "868.05 MHz" with exponent 0 results in 868050000.
+ * @param context
+ * @param special special values or NULL
+ * @param value return value in units of 10^exponent of the base unit
+ * @param exponent decimal exponent of one unit of the result
+ * @param mandatory if the parameter is mandatory
+ * @return
+ */
+scpi_bool_t SCPI_ParamNumberInt64Scaled(scpi_t * context, const scpi_choice_def_t * special, scpi_number_scaled_t * value, int8_t exponent, scpi_bool_t mandatory) {
+    scpi_token_t token;
+    lex_state_t state;
+    scpi_parameter_t param;
+    scpi_bool_t result;
+    int32_t tag;
+    int32_t unitExponent;
+    uint64_t intval;
+    double dblval;
+    const scpi_unit_def_t * unitDef = NULL;
+
+    if (!value) {
+        SCPI_ErrorPush(context, SCPI_ERROR_SYSTEM_ERROR);
+        return FALSE;
+    }
+
+    result = SCPI_Parameter(context, &param, mandatory);
+
+    if (!result) {
+        return result;
+    }
+
+    state.buffer = param.ptr;
+    state.pos = state.buffer;
+    state.len = param.len;
+
+    value->unit = SCPI_UNIT_NONE;
+    value->special = FALSE;
+    value->base = 10;
+
+    switch (param.type) {
+        case SCPI_TOKEN_HEXNUM:
+        case SCPI_TOKEN_OCTNUM:
+        case SCPI_TOKEN_BINNUM:
+            value->base = param.type == SCPI_TOKEN_HEXNUM ? 16 : (param.type == SCPI_TOKEN_OCTNUM ? 8 : 2);
+            SCPI_ParamToUInt64(context, &param, &intval);
+            value->content.value = (int64_t) intval;
+            if ((intval > (uint64_t) INT64_MAX) || !scaleInt64(&value->content.value, -exponent)) {
+                SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);
+                result = FALSE;
+            }
+            break;
+        case SCPI_TOKEN_DECIMAL_NUMERIC_PROGRAM_DATA:
+        case SCPI_TOKEN_DECIMAL_NUMERIC_PROGRAM_DATA_WITH_SUFFIX:
+            if (param.type == SCPI_TOKEN_DECIMAL_NUMERIC_PROGRAM_DATA_WITH_SUFFIX) {
+                scpiLex_DecimalNumericProgramData(&state, &token);
+                scpiLex_WhiteSpace(&state, &token);
+                scpiLex_SuffixProgramData(&state, &token);
+
+                if (!translateSuffix(context, token.ptr, token.len, &unitDef)) {
+                    result = FALSE;
+                    break;
+                }
+            }
+
+            unitExponent = 0;
+            if ((unitDef == NULL) || unitMultToExponent(unitDef->mult, &unitExponent)) {
+                result = strToInt64Scaled(param.ptr, &value->content.value, exponent - unitExponent) > 0 ? TRUE : FALSE;
+            } else {
+                /* multiplier is not a power of ten (e.g. MIN, MNT), exact conversion is not possible */
+                strToDouble(param.ptr, &dblval);
+                dblval *= unitDef->mult;
+                for (tag = exponent; tag > 0; tag--) {
+                    dblval /= 10;
+                }
+                for (tag = exponent; tag < 0; tag++) {
+                    dblval *= 10;
+                }
+                result = (dblval > -9.2e18 && dblval < 9.2e18) ? TRUE : FALSE;
+                if (result) {
+                    value->content.value = (int64_t) (dblval < 0 ? dblval - 0.5 : dblval + 0.5);
+                }
+            }
+
+            if (!result) {
+                SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);
+            } else if (unitDef != NULL) {
+                value->unit = unitDef->unit;
+            }
+            break;
+        case SCPI_TOKEN_PROGRAM_MNEMONIC:
+            scpiLex_WhiteSpace(&state, &token);
+            scpiLex_CharacterProgramData(&state, &token);
+
+            /* convert string to special number type */
+            result = SCPI_ParamToChoice(context, &token, special, &tag);
+
+            value->special = TRUE;
+            value->content.tag = tag;
+
+            break;
+        default:
+            result = FALSE;
+    }
+
+    return result;
+}
+
 /**
  * Convert scpi_number_t to string
  * @param context
@@ -483,7 +707,7 @@ size_t SCPI_NumberToStr(scpi_t * context, const scpi_choice_def_t * special, scp
     }
 
     if (value->special) {
-        if (SCPI_ChoiceToName(special, value->content.tag, &type)) {
+        if (SCPI_ChoiceToNameIndexed(context, special, value->content.tag, &type)) {
             strncpy(str, type, len);
             result = SCPIDEFINE_strnlen(str, len - 1);
             str[result] = '\0';
@@ -497,7 +721,7 @@ size_t SCPI_NumberToStr(scpi_t * context, const scpi_choice_def_t * special, scp
     result = SCPI_DoubleToStr(value->content.value, str, len);
 
     if (result + 1 < len) {
-        unit = translateUnitInverse(context->units, value->unit);
+        unit = translateUnitInverse(context, value->unit);
 
         if (unit) {
             strncat(str, " ", len - result);
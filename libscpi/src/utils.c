@@ -44,6 +44,14 @@
 #include "utils_private.h"
 #include "utils.h"
 
+/* SIMD byte swap is compiled with target attribute and selected at run time */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SWAP_ARRAY_SIMD 1
+#include <immintrin.h>
+#else
+#define SWAP_ARRAY_SIMD 0
+#endif
+
 static size_t patternSeparatorShortPos(const char * pattern, size_t len);
 static size_t patternSeparatorPos(const char * pattern, size_t len);
 static size_t cmdSeparatorPos(const char * cmd, size_t len);
@@ -336,6 +344,226 @@ size_t strToDouble(const char * str, double * val) {
     return endptr - str;
 }
 
+/**
+ * Multiply or divide unsigned 64 bit value by power of ten, result of
+ * division is rounded half away from zero
+ * @param val   value to be scaled
+ * @param shift decimal exponent of the multiplier
+ * @return      FALSE if result does not fit into 64 bits
+ */
+static scpi_bool_t scaleUInt64(uint64_t * val, int32_t shift) {
+    uint64_t divisor = 1;
+
+    for (; shift > 0; shift--) {
+        if (*val > UINT64_MAX / 10) {
+            return FALSE;
+        }
+        *val *= 10;
+    }
+
+    if (shift < -19) {
+        /* 10^20 is greater than any 64 bit value */
+        *val = 0;
+        return TRUE;
+    }
+
+    for (; shift < 0; shift++) {
+        divisor *= 10;
+    }
+
+    if (divisor > 1) {
+        uint64_t remainder = *val % divisor;
+        *val /= divisor;
+        if (remainder >= divisor - remainder) {
+            *val += 1;
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * Apply sign to unsigned 64 bit magnitude
+ * @param magnitude absolute value
+ * @param negative  TRUE for negative result
+ * @param val       signed result
+ * @return          FALSE if result does not fit into signed 64 bits
+ */
+static scpi_bool_t signInt64(uint64_t magnitude, scpi_bool_t negative, int64_t * val) {
+    if (negative) {
+        if (magnitude > (uint64_t) INT64_MAX + 1) {
+            return FALSE;
+        }
+        *val = (magnitude == (uint64_t) INT64_MAX + 1) ? INT64_MIN : -(int64_t) magnitude;
+    } else {
+        if (magnitude > (uint64_t) INT64_MAX) {
+            return FALSE;
+        }
+        *val = (int64_t) magnitude;
+    }
+    return TRUE;
+}
+
+/**
+ * Converts decimal string to fixed point signed 64 bit integer without
+ * use of floating point arithmetic. Result is expressed in units of
+ * 10^exponent and rounded half away from zero, so "868.05" with
+ * exponent -3 is converted exactly to 868050.
+ * @param str       string value
+ * @param val       fixed point result
+ * @param exponent  decimal exponent of one result unit
+ * @return          number of bytes used in string, 0 if string is not a decimal
+ *                  number or the result does not fit into 64 bits
+ */
+size_t strToInt64Scaled(const char * str, int64_t * val, int32_t exponent) {
+    const char * pos = str;
+    uint64_t mantissa = 0;
+    int32_t shift = 0;
+    int32_t exp = 0;
+    scpi_bool_t negative = FALSE;
+    scpi_bool_t digits = FALSE;
+    scpi_bool_t roundUp = FALSE;
+    scpi_bool_t dropping = FALSE;
+
+    if (*pos == '+' || *pos == '-') {
+        negative = *pos == '-';
+        pos++;
+    }
+
+    /* integer part, digits not fitting into mantissa are only counted */
+    for (; isdigit((unsigned char) *pos); pos++) {
+        digits = TRUE;
+        if (!dropping && mantissa <= (UINT64_MAX - 9) / 10) {
+            mantissa = mantissa * 10 + (*pos - '0');
+        } else {
+            if (!dropping) {
+                roundUp = *pos >= '5';
+                dropping = TRUE;
+            }
+            shift++;
+        }
+    }
+
+    /* fractional part */
+    if (*pos == '.') {
+        pos++;
+        for (; isdigit((unsigned char) *pos); pos++) {
+            digits = TRUE;
+            if (!dropping && mantissa <= (UINT64_MAX - 9) / 10) {
+                mantissa = mantissa * 10 + (*pos - '0');
+                shift--;
+            } else if (!dropping) {
+                roundUp = *pos >= '5';
+                dropping = TRUE;
+            }
+        }
+    }
+
+    if (!digits) {
+        return 0;
+    }
+
+    /* exponent part, it must contain at least one digit */
+    if (*pos == 'e' || *pos == 'E') {
+        const char * exppos = pos + 1;
+        scpi_bool_t expnegative = FALSE;
+
+        if (*exppos == '+' || *exppos == '-') {
+            expnegative = *exppos == '-';
+            exppos++;
+        }
+
+        if (isdigit((unsigned char) *exppos)) {
+            for (; isdigit((unsigned char) *exppos); exppos++) {
+                if (exp < 100000) {
+                    exp = exp * 10 + (*exppos - '0');
+                }
+            }
+            pos = exppos;
+            if (expnegative) {
+                exp = -exp;
+            }
+        }
+    }
+
+    if (roundUp) {
+        mantissa++;
+    }
+
+    if ((mantissa != 0) && !scaleUInt64(&mantissa, shift + exp - exponent)) {
+        return 0;
+    }
+
+    if (!signInt64(mantissa, negative, val)) {
+        return 0;
+    }
+
+    return pos - str;
+}
+
+/**
+ * Multiply or divide signed 64 bit value by power of ten, result of
+ * division is rounded half away from zero
+ * @param val   value to be scaled
+ * @param shift decimal exponent of the multiplier
+ * @return      FALSE if result does not fit into 64 bits
+ */
+scpi_bool_t scaleInt64(int64_t * val, int32_t shift) {
+    scpi_bool_t negative = *val < 0;
+    uint64_t magnitude = negative ? (uint64_t) 0 - (uint64_t) *val : (uint64_t) *val;
+
+    if (!scaleUInt64(&magnitude, shift)) {
+        return FALSE;
+    }
+
+    return signInt64(magnitude, negative, val);
+}
+
+/**
+ * Convert ASCII letter to upper case
+ * @param c
+ * @return upper case letter or unchanged character
+ */
+static char asciiToUpper(char c) {
+    return ((c >= 'a') && (c <= 'z')) ? (char) (c - ('a' - 'A')) : c;
+}
+
+/**
+ * Convert string to upper case in place
+ * @param str
+ * @param len
+ */
+void strToUpper(char * str, size_t len) {
+    size_t i;
+
+    for (i = 0; i < len; i++) {
+        str[i] = asciiToUpper(str[i]);
+    }
+}
+
+/**
+ * Case insensitive compare of two strings. Only str1 is folded for every
+ * character, str2 is folded just on mismatch, so comparison against already
+ * upper-cased str2 (program header) is a plain character compare.
+ * @param str1
+ * @param str2
+ * @param len
+ * @return TRUE if "len" characters of both strings are equal
+ */
+static scpi_bool_t compareUpper(const char * str1, const char * str2, size_t len) {
+    size_t i;
+    char c;
+
+    for (i = 0; i < len; i++) {
+        c = asciiToUpper(str1[i]);
+        if ((c != str2[i]) && (c != asciiToUpper(str2[i]))) {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
 /**
  * Compare two strings with exact length
  * @param str1
@@ -349,11 +577,7 @@ scpi_bool_t compareStr(const char * str1, size_t len1, const char * str2, size_t
         return FALSE;
     }
 
-    if (SCPIDEFINE_strncasecmp(str1, str2, len2) == 0) {
-        return TRUE;
-    }
-
-    return FALSE;
+    return compareUpper(str1, str2, len2);
 }
 
 /**
@@ -372,7 +596,7 @@ scpi_bool_t compareStrAndNum(const char * str1, size_t len1, const char * str2,
         return FALSE;
     }
 
-    if (SCPIDEFINE_strncasecmp(str1, str2, len1) == 0) {
+    if (compareUpper(str1, str2, len1)) {
         result = TRUE;
 
         if (num) {
@@ -416,6 +640,24 @@ size_t skipWhitespace(const char * cmd, size_t len) {
     return len;
 }
 
+/**
+ * Case insensitive FNV-1a hash of string
+ * @param str
+ * @param len
+ * @return hash value
+ */
+uint32_t hashStrCase(const char * str, size_t len) {
+    uint32_t hash = 2166136261u;
+    size_t i;
+
+    for (i = 0; i < len; i++) {
+        hash ^= (uint8_t) asciiToUpper(str[i]);
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
 /**
  * Pattern is composed from upper case an lower case letters. This function
  * search the first lowercase letter
@@ -764,7 +1006,82 @@ char *OUR_strndup(const char *s, size_t n) {
 }
 #endif
 
-#if USE_DEVICE_DEPENDENT_ERROR_INFORMATION && !USE_MEMORY_ALLOCATION_FREE
+#if USE_ERROR_INFO_POOL
+
+#if SCPI_ERROR_INFO_POOL_SIZE > 255
+#error SCPI_ERROR_INFO_POOL_SIZE must be at most 255
+#endif
+
+/**
+ * Initialize error information pool, all slots are free
+ * @param pool
+ */
+void scpipool_init(scpi_error_info_pool_t * pool) {
+    uint8_t i;
+
+    for (i = 0; i < SCPI_ERROR_INFO_POOL_SIZE; i++) {
+        pool->free_slots[i] = SCPI_ERROR_INFO_POOL_SIZE - 1 - i;
+        pool->in_use[i] = 0;
+    }
+    pool->free_count = SCPI_ERROR_INFO_POOL_SIZE;
+}
+
+/**
+ * Duplicate string into free slot of the pool. String longer than slot is
+ * truncated.
+ * @param pool
+ * @param s - string to duplicate
+ * @param n - maximal length of the string
+ * @return pointer of duplicated string or NULL if there is no free slot
+ */
+char * scpipool_strndup(scpi_error_info_pool_t * pool, const char *s, size_t n) {
+    char * slot;
+    uint8_t index;
+
+    if (!s || !pool || (*s == '\0') || (pool->free_count == 0)) {
+        return NULL;
+    }
+
+    n = SCPIDEFINE_strnlen(s, min(n, SCPI_ERROR_INFO_POOL_SLOT_LENGTH - 1));
+    index = pool->free_slots[--pool->free_count];
+    pool->in_use[index] = 1;
+    slot = pool->slots[index];
+    memcpy(slot, s, n);
+    slot[n] = '\0';
+    return slot;
+}
+
+/**
+ * Return slot of duplicated string to the pool. Pointers which are not start
+ * of a slot of this pool and slots which are already free are ignored.
+ * @param pool
+ * @param s - pointer of duplicated string or NULL
+ */
+void scpipool_free(scpi_error_info_pool_t * pool, char *s) {
+    uintptr_t offset;
+    uint8_t index;
+
+    if (!s || !pool) {
+        return;
+    }
+
+    offset = (uintptr_t) s - (uintptr_t) pool->slots[0];
+    if ((offset >= sizeof (pool->slots)) || (offset % SCPI_ERROR_INFO_POOL_SLOT_LENGTH)) {
+        return;
+    }
+
+    index = (uint8_t) (offset / SCPI_ERROR_INFO_POOL_SLOT_LENGTH);
+    if (!pool->in_use[index]) {
+        return;
+    }
+
+    pool->in_use[index] = 0;
+    pool->free_slots[pool->free_count++] = index;
+}
+
+#endif
+
+#if USE_DEVICE_DEPENDENT_ERROR_INFORMATION && !USE_ERROR_INFO_POOL && !USE_MEMORY_ALLOCATION_FREE
 
 /**
  * Initialize heap structure
@@ -1140,3 +1457,142 @@ uint64_t SCPI_Swap64(uint64_t val) {
             ((val & 0x00FF000000000000ull) >> 40) |
             ((val & 0xFF00000000000000ull) >> 56);
 }
+#if SWAP_ARRAY_SIMD
+/* pshufb masks reversing bytes of 2, 4 and 8 byte items in 16 byte lane */
+static const uint8_t swap_shuffle[3][16] = {
+    {1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14},
+    {3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12},
+    {7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8},
+};
+
+/**
+ * Get pshufb mask of item size
+ * @param item_size size of item (2, 4 or 8)
+ * @return mask
+ */
+static const uint8_t * swapShuffle(size_t item_size) {
+    return swap_shuffle[(item_size == 2) ? 0 : ((item_size == 4) ? 1 : 2)];
+}
+
+/**
+ * Swap bytes of items in whole 16 byte blocks using SSSE3
+ * @param dst destination array
+ * @param src source array
+ * @param bytes size of array in bytes
+ * @param item_size size of item (2, 4 or 8)
+ * @return number of bytes processed
+ */
+__attribute__((target("ssse3"))) static size_t swapBlocksSSSE3(uint8_t * dst, const uint8_t * src, size_t bytes, size_t item_size) {
+    const __m128i mask = _mm_loadu_si128((const __m128i *) swapShuffle(item_size));
+    size_t b;
+
+    for (b = 0; b + 16 <= bytes; b += 16) {
+        _mm_storeu_si128((__m128i *) (dst + b), _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) (src + b)), mask));
+    }
+    return b;
+}
+
+/**
+ * Swap bytes of items in whole 32 byte blocks using AVX2, items never cross
+ * 16 byte lanes, so the same mask is used in both lanes
+ * @param dst destination array
+ * @param src source array
+ * @param bytes size of array in bytes
+ * @param item_size size of item (2, 4 or 8)
+ * @return number of bytes processed
+ */
+__attribute__((target("avx2"))) static size_t swapBlocksAVX2(uint8_t * dst, const uint8_t * src, size_t bytes, size_t item_size) {
+    const __m128i lane = _mm_loadu_si128((const __m128i *) swapShuffle(item_size));
+    const __m256i mask = _mm256_broadcastsi128_si256(lane);
+    size_t b;
+
+    for (b = 0; b + 32 <= bytes; b += 32) {
+        _mm256_storeu_si256((__m256i *) (dst + b), _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *) (src + b)), mask));
+    }
+    return b;
+}
+#endif
+
+/**
+ * Copy array and swap bytes of each item using given implementation
+ * @param impl implementation
+ * @param dst destination array, must not overlap with src
+ * @param src source array
+ * @param count number of items
+ * @param item_size size of item (2, 4 or 8)
+ * @return FALSE if the implementation is not supported by compiler or CPU
+ */
+scpi_bool_t swapArrayImpl(scpi_swap_impl_t impl, void * dst, const void * src, size_t count, size_t item_size) {
+    size_t i = 0;
+
+    switch (impl) {
+        case SCPI_SWAP_SCALAR:
+            break;
+#if SWAP_ARRAY_SIMD
+        case SCPI_SWAP_SSSE3:
+            if (!__builtin_cpu_supports("ssse3")) {
+                return FALSE;
+            }
+            i = swapBlocksSSSE3((uint8_t *) dst, (const uint8_t *) src, count * item_size, item_size) / item_size;
+            break;
+        case SCPI_SWAP_AVX2:
+            if (!__builtin_cpu_supports("avx2")) {
+                return FALSE;
+            }
+            i = swapBlocksAVX2((uint8_t *) dst, (const uint8_t *) src, count * item_size, item_size) / item_size;
+            break;
+#endif
+        default:
+            return FALSE;
+    }
+
+    switch (item_size) {
+        case 2:
+            for (; i < count; i++) {
+                ((uint16_t *) dst)[i] = SCPI_Swap16(((const uint16_t *) src)[i]);
+            }
+            break;
+        case 4:
+            for (; i < count; i++) {
+                ((uint32_t *) dst)[i] = SCPI_Swap32(((const uint32_t *) src)[i]);
+            }
+            break;
+        case 8:
+            for (; i < count; i++) {
+                ((uint64_t *) dst)[i] = SCPI_Swap64(((const uint64_t *) src)[i]);
+            }
+            break;
+        default:
+            break;
+    }
+    return TRUE;
+}
+
+/**
+ * Copy array and swap bytes of each item. The fastest implementation supported
+ * by the CPU is selected on the first call, tail shorter than SIMD block is
+ * swapped by plain C.
+ * @param dst destination array, must not overlap with src
+ * @param src source array
+ * @param count number of items
+ * @param item_size size of item (2, 4 or 8)
+ */
+void swapArray(void * dst, const void * src, size_t count, size_t item_size) {
+    static scpi_swap_impl_t impl = SCPI_SWAP_UNKNOWN;
+
+    if (impl == SCPI_SWAP_UNKNOWN) {
+#if SWAP_ARRAY_SIMD
+        if (__builtin_cpu_supports("avx2")) {
+            impl = SCPI_SWAP_AVX2;
+        } else if (__builtin_cpu_supports("ssse3")) {
+            impl = SCPI_SWAP_SSSE3;
+        } else
+#endif
+        {
+            impl = SCPI_SWAP_SCALAR;
+        }
+    }
+
+    swapArrayImpl(impl, dst, src, count, item_size);
+}
+
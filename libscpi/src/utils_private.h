@@ -55,6 +55,8 @@ extern "C" {
     char * strnpbrk(const char *str, size_t size, const char *set) LOCAL;
     scpi_bool_t compareStr(const char * str1, size_t len1, const char * str2, size_t len2) LOCAL;
     scpi_bool_t compareStrAndNum(const char * str1, size_t len1, const char * str2, size_t len2, int32_t * num) LOCAL;
+    uint32_t hashStrCase(const char * str, size_t len) LOCAL;
+    void strToUpper(char * str, size_t len) LOCAL;
     size_t UInt32ToStrBaseSign(uint32_t val, char * str, size_t len, int8_t base, scpi_bool_t sign) LOCAL;
     size_t UInt64ToStrBaseSign(uint64_t val, char * str, size_t len, int8_t base, scpi_bool_t sign) LOCAL;
     size_t strBaseToInt32(const char * str, int32_t * val, int8_t base) LOCAL;
@@ -63,6 +65,8 @@ extern "C" {
     size_t strBaseToUInt64(const char * str, uint64_t * val, int8_t base) LOCAL;
     size_t strToFloat(const char * str, float * val) LOCAL;
     size_t strToDouble(const char * str, double * val) LOCAL;
+    size_t strToInt64Scaled(const char * str, int64_t * val, int32_t exponent) LOCAL;
+    scpi_bool_t scaleInt64(int64_t * val, int32_t shift) LOCAL;
     scpi_bool_t locateText(const char * str1, size_t len1, const char ** str2, size_t * len2) LOCAL;
     scpi_bool_t locateStr(const char * str1, size_t len1, const char ** str2, size_t * len2) LOCAL;
     size_t skipWhitespace(const char * cmd, size_t len) LOCAL;
@@ -79,6 +83,16 @@ extern "C" {
     uint16_t SCPI_Swap16(uint16_t val);
     uint32_t SCPI_Swap32(uint32_t val);
     uint64_t SCPI_Swap64(uint64_t val);
+    void swapArray(void * dst, const void * src, size_t count, size_t item_size) LOCAL;
+
+    /* byte swap implementations of swapArray */
+    typedef enum {
+        SCPI_SWAP_UNKNOWN = -1,
+        SCPI_SWAP_SCALAR = 0,
+        SCPI_SWAP_SSSE3,
+        SCPI_SWAP_AVX2,
+    } scpi_swap_impl_t;
+    scpi_bool_t swapArrayImpl(scpi_swap_impl_t impl, void * dst, const void * src, size_t count, size_t item_size) LOCAL;
 
 #if !HAVE_STRNLEN
     size_t BSD_strnlen(const char *s, size_t maxlen) LOCAL;
@@ -88,13 +102,19 @@ extern "C" {
     int OUR_strncasecmp(const char *s1, const char *s2, size_t n) LOCAL;
 #endif
 
-#if USE_DEVICE_DEPENDENT_ERROR_INFORMATION && !USE_MEMORY_ALLOCATION_FREE
+#if USE_DEVICE_DEPENDENT_ERROR_INFORMATION && !USE_ERROR_INFO_POOL && !USE_MEMORY_ALLOCATION_FREE
     void scpiheap_init(scpi_error_info_heap_t * heap, char * error_info_heap, size_t error_info_heap_length);
     char * scpiheap_strndup(scpi_error_info_heap_t * heap, const char *s, size_t n) LOCAL;
     void scpiheap_free(scpi_error_info_heap_t * heap, char *s, scpi_bool_t rollback) LOCAL;
     scpi_bool_t scpiheap_get_parts(scpi_error_info_heap_t * heap, const char *s1, size_t * len1, const char ** s2, size_t * len2) LOCAL;
 #endif
 
+#if USE_ERROR_INFO_POOL
+    void scpipool_init(scpi_error_info_pool_t * pool) LOCAL;
+    char * scpipool_strndup(scpi_error_info_pool_t * pool, const char *s, size_t n) LOCAL;
+    void scpipool_free(scpi_error_info_pool_t * pool, char *s) LOCAL;
+#endif
+
 #if !HAVE_STRNDUP
     char *OUR_strndup(const char *s, size_t n);
 #endif
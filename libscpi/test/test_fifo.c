@@ -167,6 +167,54 @@ static void testFifo() {
     CU_ASSERT_FALSE(fifo_remove_last(&fifo, NULL));
 }
 
+static void testFifoSpsc() {
+#if USE_ERROR_ISR_QUEUE
+    scpi_fifo_spsc_t fifo;
+    int16_t value;
+    int i;
+    int round;
+
+    fifo_spsc_init(&fifo);
+    CU_ASSERT_FALSE(fifo_spsc_remove(&fifo, &value));
+    CU_ASSERT_EQUAL(fifo_spsc_dropped(&fifo), 0);
+
+    /* several rounds to wrap the indexes around the ring */
+    for (round = 0; round < 3; round++) {
+        for (i = 0; i < SCPI_ERROR_ISR_QUEUE_SIZE; i++) {
+            CU_ASSERT_TRUE(fifo_spsc_add(&fifo, i + round));
+        }
+        CU_ASSERT_FALSE(fifo_spsc_add(&fifo, 100));
+        CU_ASSERT_FALSE(fifo_spsc_add(&fifo, 101));
+        CU_ASSERT_EQUAL(fifo_spsc_dropped(&fifo), 2);
+        CU_ASSERT_EQUAL(fifo_spsc_dropped(&fifo), 0);
+
+        CU_ASSERT_TRUE(fifo_spsc_remove(&fifo, &value));
+        CU_ASSERT_EQUAL(value, round);
+        CU_ASSERT_TRUE(fifo_spsc_add(&fifo, 200));
+        for (i = 1; i < SCPI_ERROR_ISR_QUEUE_SIZE; i++) {
+            CU_ASSERT_TRUE(fifo_spsc_remove(&fifo, &value));
+            CU_ASSERT_EQUAL(value, i + round);
+        }
+        CU_ASSERT_TRUE(fifo_spsc_remove(&fifo, &value));
+        CU_ASSERT_EQUAL(value, 200);
+        CU_ASSERT_FALSE(fifo_spsc_remove(&fifo, &value));
+    }
+
+    /* free running 16 bit indexes overflow */
+    fifo.wr = fifo.rd = 0xFFFE;
+    CU_ASSERT_TRUE(fifo_spsc_add(&fifo, 1));
+    CU_ASSERT_TRUE(fifo_spsc_add(&fifo, 2));
+    CU_ASSERT_TRUE(fifo_spsc_add(&fifo, 3));
+    CU_ASSERT_TRUE(fifo_spsc_remove(&fifo, &value));
+    CU_ASSERT_EQUAL(value, 1);
+    CU_ASSERT_TRUE(fifo_spsc_remove(&fifo, &value));
+    CU_ASSERT_EQUAL(value, 2);
+    CU_ASSERT_TRUE(fifo_spsc_remove(&fifo, &value));
+    CU_ASSERT_EQUAL(value, 3);
+    CU_ASSERT_FALSE(fifo_spsc_remove(&fifo, &value));
+#endif
+}
+
 int main() {
     unsigned int result;
     CU_pSuite pSuite = NULL;
@@ -183,7 +231,8 @@ int main() {
     }
 
     /* Add the tests to the suite */
-    if ((NULL == CU_add_test(pSuite, "test fifo", testFifo))) {
+    if ((NULL == CU_add_test(pSuite, "test fifo", testFifo))
+            || (NULL == CU_add_test(pSuite, "test fifo spsc", testFifoSpsc))) {
         CU_cleanup_registry();
         return CU_get_error();
     }
@@ -0,0 +1,168 @@
+/*-
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2012-2018, Jan Breuer
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*
+ * Parallel ASCII array formatting is compiled into this test with small
+ * chunks and compared to serial formatting of the same parser source.
+ */
+#define USE_PARALLEL_ARRAY_FORMAT 1
+#define SCPI_PARALLEL_ARRAY_FORMAT_CHUNK 16
+#define SCPI_PARALLEL_ARRAY_FORMAT_THREADS 4
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "CUnit/Basic.h"
+
+#include "../src/parser.c"
+
+#define TEST_OUTPUT_LENGTH 65536
+
+static char output_buffer[TEST_OUTPUT_LENGTH];
+static size_t output_buffer_pos = 0;
+
+static size_t output_write(scpi_t * context, const char * data, size_t len) {
+    (void) context;
+    if (len > sizeof (output_buffer) - output_buffer_pos) {
+        len = sizeof (output_buffer) - output_buffer_pos;
+    }
+    memcpy(output_buffer + output_buffer_pos, data, len);
+    output_buffer_pos += len;
+    return len;
+}
+
+static scpi_interface_t test_interface = {
+    .write = output_write,
+};
+
+/*
+ * CUnit Test Suite
+ */
+
+static int init_suite(void) {
+    return 0;
+}
+
+static int clean_suite(void) {
+    return 0;
+}
+
+/**
+ * Format array serially and in parallel, starting with and without
+ * preceding result, and compare output byte for byte
+ */
+static void checkParallelFormat(const void * array, size_t count, size_t item_size, result_array_format_t format) {
+    static char serial[TEST_OUTPUT_LENGTH];
+    scpi_t context;
+    size_t serial_len;
+    size_t serial_result;
+    size_t parallel_result;
+    int_fast16_t serial_count;
+    int_fast16_t preceding;
+
+    for (preceding = 0; preceding <= 1; preceding++) {
+        memset(&context, 0, sizeof (context));
+        context.interface = &test_interface;
+
+        context.output_count = preceding;
+        output_buffer_pos = 0;
+        serial_result = produceResultArrayAscii(&context, array, count, item_size, format);
+        serial_len = output_buffer_pos;
+        serial_count = context.output_count;
+        memcpy(serial, output_buffer, serial_len);
+
+        context.output_count = preceding;
+        output_buffer_pos = 0;
+        parallel_result = produceResultArrayAsciiParallel(&context, array, count, item_size, format);
+
+        CU_ASSERT_EQUAL(parallel_result, serial_result);
+        CU_ASSERT_EQUAL(output_buffer_pos, serial_len);
+        CU_ASSERT_EQUAL(context.output_count, serial_count);
+        CU_ASSERT_EQUAL(memcmp(output_buffer, serial, serial_len), 0);
+    }
+}
+
+static void testParallelFormat(void) {
+    static const size_t counts[] = {0, 1, 31, 32, 33, 63, 64, 65, 100, 1000};
+    static double doubles[1000];
+    static int32_t ints[1000];
+    static int8_t bytes[1000];
+    scpi_t context;
+    size_t i;
+
+    for (i = 0; i < 1000; i++) {
+        doubles[i] = (double) i * 1.25e-3 - 0.5;
+        ints[i] = (int32_t) (i * 2654435761u);
+        bytes[i] = (int8_t) i;
+    }
+
+    for (i = 0; i < sizeof (counts) / sizeof (counts[0]); i++) {
+        checkParallelFormat(doubles, counts[i], sizeof (double), formatArrayDouble);
+        checkParallelFormat(ints, counts[i], sizeof (int32_t), formatArrayInt32);
+        checkParallelFormat(bytes, counts[i], sizeof (int8_t), formatArrayInt8);
+    }
+
+    /* public function uses parallel path */
+    memset(&doubles, 0, sizeof (doubles));
+    memset(&context, 0, sizeof (context));
+    context.interface = &test_interface;
+    output_buffer_pos = 0;
+    SCPI_ResultArrayDouble(&context, doubles, 40, SCPI_FORMAT_ASCII);
+    CU_ASSERT_EQUAL(output_buffer_pos, 40 * 2 - 1);
+    CU_ASSERT_EQUAL(memcmp(output_buffer, "0,0,0", 5), 0);
+    CU_ASSERT_EQUAL(context.output_count, 40);
+}
+
+int main() {
+    unsigned int result;
+    CU_pSuite pSuite = NULL;
+
+    /* Initialize the CUnit test registry */
+    if (CUE_SUCCESS != CU_initialize_registry())
+        return CU_get_error();
+
+    /* Add a suite to the registry */
+    pSuite = CU_add_suite("Parallel array format", init_suite, clean_suite);
+    if (NULL == pSuite) {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    /* Add the tests to the suite */
+    if ((NULL == CU_add_test(pSuite, "parallel vs serial", testParallelFormat))) {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    /* Run all tests using the CUnit Basic interface */
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    result = CU_get_number_of_tests_failed();
+    CU_cleanup_registry();
+    return result ? result : CU_get_error();
+}
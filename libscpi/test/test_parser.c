@@ -32,6 +32,7 @@
 
 #include "scpi/scpi.h"
 #include "../src/fifo_private.h"
+#include "../src/utils_private.h"
 
 /*
  * CUnit Test Suite
@@ -98,6 +99,8 @@ static const scpi_command_t scpi_commands[] = {
     /* Required SCPI commands (SCPI std V1999.0 4.2.1) */
     { .pattern = "SYSTem:ERRor[:NEXT]?", .callback = SCPI_SystemErrorNextQ,},
     { .pattern = "SYSTem:ERRor:COUNt?", .callback = SCPI_SystemErrorCountQ,},
+    { .pattern = "SYSTem:ERRor:ALL?", .callback = SCPI_SystemErrorAllQ,},
+    { .pattern = "SYSTem:ERRor:STATus?", .callback = SCPI_SystemErrorStatusQ,},
     { .pattern = "SYSTem:VERSion?", .callback = SCPI_SystemVersionQ,},
 
     { .pattern = "STATus:QUEStionable[:EVENt]?", .callback = SCPI_StatusQuestionableEventQ,},
@@ -125,8 +128,9 @@ static const scpi_command_t scpi_commands[] = {
 };
 
 
-char output_buffer[1024];
+char output_buffer[4096];
 size_t output_buffer_pos = 0;
+size_t output_buffer_writes = 0;
 
 int_fast16_t err_buffer[128];
 size_t err_buffer_pos = 0;
@@ -134,12 +138,14 @@ size_t err_buffer_pos = 0;
 static void output_buffer_clear(void) {
     output_buffer[0] = '\0';
     output_buffer_pos = 0;
+    output_buffer_writes = 0;
 }
 
 static size_t output_buffer_write(const char * data, size_t len) {
     memcpy(output_buffer + output_buffer_pos, data, len);
     output_buffer_pos += len;
     output_buffer[output_buffer_pos] = '\0';
+    output_buffer_writes++;
     return len;
 }
 
@@ -165,6 +171,22 @@ static size_t SCPI_Write(scpi_t * context, const char * data, size_t len) {
     return output_buffer_write(data, len);
 }
 
+static const char * write_vector_payload = NULL;
+
+static size_t SCPI_WriteVector(scpi_t * context, const scpi_iovec_t * iov, size_t iovcnt) {
+    size_t result = 0;
+    size_t i;
+    (void) context;
+
+    write_vector_payload = (iovcnt > 1) ? iov[1].data : NULL;
+    for (i = 0; i < iovcnt; i++) {
+        result += output_buffer_write(iov[i].data, iov[i].len);
+    }
+    output_buffer_writes -= iovcnt - 1;
+
+    return result;
+}
+
 static scpi_result_t SCPI_Flush(scpi_t * context) {
     (void) context;
 
@@ -226,7 +248,7 @@ static int init_suite(void) {
             "MA", "IN", NULL, "VER",
             scpi_input_buffer, SCPI_INPUT_BUFFER_LENGTH,
             scpi_error_queue_data, SCPI_ERROR_QUEUE_SIZE);
-#if USE_DEVICE_DEPENDENT_ERROR_INFORMATION && !USE_MEMORY_ALLOCATION_FREE
+#if USE_DEVICE_DEPENDENT_ERROR_INFORMATION && !USE_ERROR_INFO_POOL && !USE_MEMORY_ALLOCATION_FREE
     SCPI_InitHeap(&scpi_context,
             error_info_heap, SCPI_ERROR_INFO_HEAP_SIZE);
 #endif
@@ -428,8 +450,35 @@ static void testIEEE4882(void) {
 #endif /* USE_DEVICE_DEPENDENT_ERROR_INFORMATION */
     TEST_IEEE4882("SYST:ERR:NEXT?\r\n", "0,\"No error\"\r\n");
 
+    /* header is matched case insensitively without modifying the input */
+    {
+        static const char lower_case[] = "syst:err:coun?;:abCd\r\n";
+        char input[sizeof (lower_case)];
+        memcpy(input, lower_case, sizeof (lower_case));
+        SCPI_Parse(&scpi_context, input, strlen(input));
+        CU_ASSERT_STRING_EQUAL(input, lower_case);
+        CU_ASSERT_STRING_EQUAL("0\r\n", output_buffer);
+        output_buffer_clear();
+    }
+#if USE_DEVICE_DEPENDENT_ERROR_INFORMATION
+    TEST_IEEE4882("SYST:ERR:NEXT?\r\n", "-113,\"Undefined header;:abCd\"\r\n");
+#else /* USE_DEVICE_DEPENDENT_ERROR_INFORMATION */
+    TEST_IEEE4882("SYST:ERR:NEXT?\r\n", "-113,\"Undefined header\"\r\n");
+#endif /* USE_DEVICE_DEPENDENT_ERROR_INFORMATION */
+    TEST_IEEE4882("*ESR?\r\n", "32\r\n");
+
     TEST_IEEE4882("*STB?\r\n", "0\r\n"); /* Error queue is now empty */
 
+    TEST_IEEE4882("SYST:ERR:ALL?\r\n", "0,\"No error\"\r\n");
+    TEST_IEEE4882("SYST:ERR:STAT?\r\n", "0,0\r\n");
+    SCPI_ErrorPush(&scpi_context, SCPI_ERROR_INVALID_CHARACTER);
+    SCPI_ErrorPush(&scpi_context, SCPI_ERROR_UNDEFINED_HEADER);
+    TEST_IEEE4882("SYST:ERR:STAT?\r\n", "2,32\r\n");
+    TEST_IEEE4882("SYST:ERR:STAT?\r\n", "2,0\r\n");
+    TEST_IEEE4882("SYST:ERR:ALL?\r\n", "-101,\"Invalid character\",-113,\"Undefined header\"\r\n");
+    TEST_IEEE4882("SYST:ERR:COUN?\r\n", "0\r\n");
+    TEST_IEEE4882("*STB?\r\n", "0\r\n");
+
     scpi_context.interface->control = NULL;
     srq_val = 0;
     TEST_IEEE4882("ABCD\r\n", ""); /* "Undefined header" cause command error */
@@ -902,6 +951,60 @@ static void testSCPI_ParamChoice(void) {
     TEST_ParamChoice("SOUR", TRUE, 3, TRUE, 0);
 }
 
+#if USE_CHOICE_INDEX
+static const scpi_choice_def_t test_indexed_options[] = {
+    {"OPTIONA", 1},
+    {"OPTIONB", 2},
+    {"SOURce", 3},
+    {"SOURce", 4},
+    {"SOUR", 5},
+    {"SENSe", 3},
+    SCPI_CHOICE_LIST_END /* termination of option list */
+};
+static scpi_choice_index_t test_indexed_options_index;
+
+static void testSCPI_ParamChoiceIndex(void) {
+    const scpi_choice_def_t * test_options = test_indexed_options;
+    const char * text;
+    scpi_choice_def_t numbered_options[] = {
+        {"CHANnel#", 1},
+        SCPI_CHOICE_LIST_END
+    };
+    scpi_choice_index_t numbered_index;
+
+    CU_ASSERT_FALSE(SCPI_ChoiceIndexInit(&numbered_index, numbered_options));
+    CU_ASSERT_FALSE(SCPI_ChoiceIndexRegister(&scpi_context, &numbered_index));
+
+    CU_ASSERT_TRUE(SCPI_ChoiceIndexInit(&test_indexed_options_index, test_indexed_options));
+    CU_ASSERT_TRUE(SCPI_ChoiceIndexRegister(&scpi_context, &test_indexed_options_index));
+
+    TEST_ParamChoice("ON", TRUE, 0, FALSE, SCPI_ERROR_ILLEGAL_PARAMETER_VALUE);
+    TEST_ParamChoice("OPTIONA", TRUE, 1, TRUE, 0);
+    TEST_ParamChoice("optionb", TRUE, 2, TRUE, 0);
+    TEST_ParamChoice("SOURCE", TRUE, 3, TRUE, 0);
+    TEST_ParamChoice("sour", TRUE, 3, TRUE, 0);
+    TEST_ParamChoice("SOURC", TRUE, 0, FALSE, SCPI_ERROR_ILLEGAL_PARAMETER_VALUE);
+    TEST_ParamChoice("SENS", TRUE, 3, TRUE, 0);
+    TEST_ParamChoice("1", TRUE, 0, FALSE, SCPI_ERROR_DATA_TYPE_ERROR);
+
+    CU_ASSERT_TRUE(SCPI_ChoiceToNameIndexed(&scpi_context, test_indexed_options, 3, &text));
+    CU_ASSERT_STRING_EQUAL(text, "SOURce");
+    CU_ASSERT_TRUE(SCPI_ChoiceToNameIndexed(&scpi_context, test_indexed_options, 5, &text));
+    CU_ASSERT_STRING_EQUAL(text, "SOUR");
+    CU_ASSERT_FALSE(SCPI_ChoiceToNameIndexed(&scpi_context, test_indexed_options, 6, &text));
+    CU_ASSERT_TRUE(SCPI_ChoiceToNameIndexed(&scpi_context, scpi_bool_def, 1, &text));
+    CU_ASSERT_STRING_EQUAL(text, "ON");
+
+    /* leave the shared context as other tests expect it */
+    CU_ASSERT_TRUE(SCPI_ChoiceIndexUnregister(&scpi_context, &test_indexed_options_index));
+    CU_ASSERT_FALSE(SCPI_ChoiceIndexUnregister(&scpi_context, &test_indexed_options_index));
+    TEST_ParamChoice("SOURC", TRUE, 0, FALSE, SCPI_ERROR_ILLEGAL_PARAMETER_VALUE);
+    TEST_ParamChoice("SENS", TRUE, 3, TRUE, 0);
+    CU_ASSERT_TRUE(SCPI_ChoiceToNameIndexed(&scpi_context, scpi_bool_def, 1, &text));
+    CU_ASSERT_STRING_EQUAL(text, "ON");
+}
+#endif
+
 #define TEST_NumericListInt(data, index, expected_range, expected_from, expected_to, expected_result, expected_error_code) \
 {                                                                                       \
     scpi_bool_t result;                                                                 \
@@ -1058,6 +1161,167 @@ static void testChannelList(void) {
     TEST_ChannelList("abcd", 1, 1, FALSE, 0, (0), (0), SCPI_EXPR_ERROR, SCPI_ERROR_DATA_TYPE_ERROR);
 }
 
+#define TEST_ExprListToArray(func, data, i_count, _expected, expected_count, expected_result, expected_error_code) \
+{                                                                                       \
+    scpi_expr_result_t result;                                                          \
+    scpi_error_t errCode;                                                               \
+    scpi_parameter_t param;                                                             \
+    int32_t values[i_count + 1];                                                        \
+    int32_t expected[] = {NOPAREN _expected};                                           \
+    size_t o_count;                                                                     \
+                                                                                        \
+    SCPI_CoreCls(&scpi_context);                                                        \
+    scpi_context.input_count = 0;                                                       \
+    scpi_context.param_list.lex_state.buffer = data;                                    \
+    scpi_context.param_list.lex_state.len = strlen(scpi_context.param_list.lex_state.buffer);\
+    scpi_context.param_list.lex_state.pos = scpi_context.param_list.lex_state.buffer;   \
+    SCPI_Parameter(&scpi_context, &param, TRUE);                                        \
+    result = func(&scpi_context, &param, values, i_count, &o_count);                    \
+    SCPI_ErrorPop(&scpi_context, &errCode);                                             \
+    CU_ASSERT_EQUAL(result, expected_result);                                           \
+    if (expected_result == SCPI_EXPR_OK) {                                              \
+        CU_ASSERT_EQUAL(o_count, expected_count);                                       \
+        { size_t i; for(i = 0; i < o_count; i++) {                                      \
+            CU_ASSERT_EQUAL(values[i], expected[i]);                                    \
+        }}                                                                              \
+    }                                                                                   \
+    CU_ASSERT_EQUAL(errCode.error_code, expected_error_code);                           \
+}
+
+static void testExprListIterator(void) {
+    scpi_parameter_t param;
+    scpi_expr_list_t list;
+    scpi_bool_t isRange;
+    int32_t valueFrom;
+    int32_t valueTo;
+    size_t dimensions;
+    int32_t sum = 0;
+    int entries = 0;
+
+    SCPI_CoreCls(&scpi_context);
+    scpi_context.input_count = 0;
+    scpi_context.param_list.lex_state.buffer = "(@1:5,7,9:200)";
+    scpi_context.param_list.lex_state.len = strlen(scpi_context.param_list.lex_state.buffer);
+    scpi_context.param_list.lex_state.pos = scpi_context.param_list.lex_state.buffer;
+    SCPI_Parameter(&scpi_context, &param, TRUE);
+
+    CU_ASSERT_EQUAL(SCPI_ExprChannelListBegin(&scpi_context, &param, &list), SCPI_EXPR_OK);
+    while (SCPI_ExprChannelListNext(&scpi_context, &list, &isRange, &valueFrom, &valueTo, 1, &dimensions) == SCPI_EXPR_OK) {
+        CU_ASSERT_EQUAL(dimensions, 1);
+        sum += isRange ? valueTo - valueFrom + 1 : 1;
+        entries++;
+    }
+    CU_ASSERT_EQUAL(entries, 3);
+    CU_ASSERT_EQUAL(sum, 198);
+    CU_ASSERT_EQUAL(SCPI_ExprChannelListNext(&scpi_context, &list, &isRange, &valueFrom, &valueTo, 1, &dimensions), SCPI_EXPR_NO_MORE);
+
+    SCPI_CoreCls(&scpi_context);
+    scpi_context.input_count = 0;
+    scpi_context.param_list.lex_state.buffer = "(3,4:2.5)";
+    scpi_context.param_list.lex_state.len = strlen(scpi_context.param_list.lex_state.buffer);
+    scpi_context.param_list.lex_state.pos = scpi_context.param_list.lex_state.buffer;
+    SCPI_Parameter(&scpi_context, &param, TRUE);
+
+    CU_ASSERT_EQUAL(SCPI_ExprNumericListBegin(&scpi_context, &param, &list), SCPI_EXPR_OK);
+    CU_ASSERT_EQUAL(SCPI_ExprNumericListNextInt(&scpi_context, &list, &isRange, &valueFrom, &valueTo), SCPI_EXPR_OK);
+    CU_ASSERT_FALSE(isRange);
+    CU_ASSERT_EQUAL(valueFrom, 3);
+    {
+        double from, to;
+        CU_ASSERT_EQUAL(SCPI_ExprNumericListNextDouble(&scpi_context, &list, &isRange, &from, &to), SCPI_EXPR_OK);
+        CU_ASSERT_TRUE(isRange);
+        CU_ASSERT_DOUBLE_EQUAL(from, 4, 0);
+        CU_ASSERT_DOUBLE_EQUAL(to, 2.5, 0);
+    }
+    CU_ASSERT_EQUAL(SCPI_ExprNumericListNextInt(&scpi_context, &list, &isRange, &valueFrom, &valueTo), SCPI_EXPR_NO_MORE);
+}
+
+static void testExprListToArray(void) {
+    TEST_ExprListToArray(SCPI_ExprNumericListToArrayInt, "(1:3,7)", 10, (1, 2, 3, 7), 4, SCPI_EXPR_OK, 0);
+    TEST_ExprListToArray(SCPI_ExprNumericListToArrayInt, "(5:3,-1)", 10, (5, 4, 3, -1), 4, SCPI_EXPR_OK, 0);
+    TEST_ExprListToArray(SCPI_ExprNumericListToArrayInt, "()", 10, (0), 0, SCPI_EXPR_OK, 0);
+    TEST_ExprListToArray(SCPI_ExprNumericListToArrayInt, "(1:3,7)", 4, (1, 2, 3, 7), 4, SCPI_EXPR_OK, 0);
+    TEST_ExprListToArray(SCPI_ExprNumericListToArrayInt, "(1:3,7)", 3, (0), 0, SCPI_EXPR_ERROR, SCPI_ERROR_TOO_MUCH_DATA);
+    TEST_ExprListToArray(SCPI_ExprNumericListToArrayInt, "(1,2:)", 10, (0), 0, SCPI_EXPR_ERROR, SCPI_ERROR_EXPRESSION_PARSING_ERROR);
+    TEST_ExprListToArray(SCPI_ExprNumericListToArrayInt, "abcd", 10, (0), 0, SCPI_EXPR_ERROR, SCPI_ERROR_DATA_TYPE_ERROR);
+
+    TEST_ExprListToArray(SCPI_ExprChannelListToArray, "(@1:5,7,9:11)", 10, (1, 2, 3, 4, 5, 7, 9, 10, 11), 9, SCPI_EXPR_OK, 0);
+    TEST_ExprListToArray(SCPI_ExprChannelListToArray, "(@1:5,7,9:200)", 10, (0), 0, SCPI_EXPR_ERROR, SCPI_ERROR_TOO_MUCH_DATA);
+    TEST_ExprListToArray(SCPI_ExprChannelListToArray, "(@1,2!5)", 10, (0), 0, SCPI_EXPR_ERROR, SCPI_ERROR_ILLEGAL_PARAMETER_VALUE);
+    TEST_ExprListToArray(SCPI_ExprChannelListToArray, "(1,2)", 10, (0), 0, SCPI_EXPR_ERROR, SCPI_ERROR_EXPRESSION_PARSING_ERROR);
+}
+
+static void testExprRangeSet(void) {
+    scpi_parameter_t param;
+    scpi_expr_range_t ranges[3];
+    scpi_expr_range_set_t set;
+    scpi_error_t errCode;
+    uint8_t bitmap[2];
+    int32_t value;
+
+    SCPI_ExprRangeSetInit(&set, ranges, 3);
+    CU_ASSERT_FALSE(SCPI_ExprRangeSetFirst(&set, &value));
+    CU_ASSERT_TRUE(SCPI_ExprRangeSetAdd(&set, 10, 12));
+    CU_ASSERT_TRUE(SCPI_ExprRangeSetAdd(&set, 1, 3));
+    CU_ASSERT_TRUE(SCPI_ExprRangeSetAdd(&set, 6, 5));
+    CU_ASSERT_EQUAL(set.count, 3);
+    CU_ASSERT_FALSE(SCPI_ExprRangeSetAdd(&set, 20, 20));
+    CU_ASSERT_TRUE(SCPI_ExprRangeSetAdd(&set, 4, 4));
+    CU_ASSERT_EQUAL(set.count, 2);
+    CU_ASSERT_EQUAL(set.ranges[0].from, 1);
+    CU_ASSERT_EQUAL(set.ranges[0].to, 6);
+    CU_ASSERT_TRUE(SCPI_ExprRangeSetAdd(&set, 2, 9));
+    CU_ASSERT_EQUAL(set.count, 1);
+    CU_ASSERT_EQUAL(set.ranges[0].to, 12);
+    CU_ASSERT_TRUE(SCPI_ExprRangeSetAdd(&set, INT32_MIN, INT32_MIN));
+    CU_ASSERT_TRUE(SCPI_ExprRangeSetAdd(&set, INT32_MAX - 1, INT32_MAX));
+    CU_ASSERT_EQUAL(SCPI_ExprRangeSetCount(&set), 15);
+    CU_ASSERT_TRUE(SCPI_ExprRangeSetContains(&set, INT32_MAX));
+    CU_ASSERT_TRUE(SCPI_ExprRangeSetContains(&set, 12));
+    CU_ASSERT_FALSE(SCPI_ExprRangeSetContains(&set, 13));
+    CU_ASSERT_FALSE(SCPI_ExprRangeSetContains(&set, 0));
+
+    CU_ASSERT_TRUE(SCPI_ExprRangeSetFirst(&set, &value));
+    CU_ASSERT_EQUAL(value, INT32_MIN);
+    CU_ASSERT_TRUE(SCPI_ExprRangeSetNext(&set, &value));
+    CU_ASSERT_EQUAL(value, 1);
+    value = 12;
+    CU_ASSERT_TRUE(SCPI_ExprRangeSetNext(&set, &value));
+    CU_ASSERT_EQUAL(value, INT32_MAX - 1);
+    CU_ASSERT_TRUE(SCPI_ExprRangeSetNext(&set, &value));
+    CU_ASSERT_FALSE(SCPI_ExprRangeSetNext(&set, &value));
+
+    SCPI_CoreCls(&scpi_context);
+    scpi_context.input_count = 0;
+    scpi_context.param_list.lex_state.buffer = "(@1:1000,2000:3000,1001,5)";
+    scpi_context.param_list.lex_state.len = strlen(scpi_context.param_list.lex_state.buffer);
+    scpi_context.param_list.lex_state.pos = scpi_context.param_list.lex_state.buffer;
+    SCPI_Parameter(&scpi_context, &param, TRUE);
+    CU_ASSERT_EQUAL(SCPI_ExprChannelListToRangeSet(&scpi_context, &param, &set), SCPI_EXPR_OK);
+    CU_ASSERT_EQUAL(set.count, 2);
+    CU_ASSERT_EQUAL(SCPI_ExprRangeSetCount(&set), 2002);
+    CU_ASSERT_FALSE(SCPI_ExprRangeSetToBitmap(&set, 0, bitmap, 16));
+
+    scpi_context.input_count = 0;
+    scpi_context.param_list.lex_state.buffer = "(3:1,9,15)";
+    scpi_context.param_list.lex_state.len = strlen(scpi_context.param_list.lex_state.buffer);
+    scpi_context.param_list.lex_state.pos = scpi_context.param_list.lex_state.buffer;
+    SCPI_Parameter(&scpi_context, &param, TRUE);
+    CU_ASSERT_EQUAL(SCPI_ExprNumericListToRangeSet(&scpi_context, &param, &set), SCPI_EXPR_OK);
+    CU_ASSERT_TRUE(SCPI_ExprRangeSetToBitmap(&set, 0, bitmap, 16));
+    CU_ASSERT_EQUAL(bitmap[0], 0x0E);
+    CU_ASSERT_EQUAL(bitmap[1], 0x82);
+
+    scpi_context.input_count = 0;
+    scpi_context.param_list.lex_state.buffer = "(1,3,5,7)";
+    scpi_context.param_list.lex_state.len = strlen(scpi_context.param_list.lex_state.buffer);
+    scpi_context.param_list.lex_state.pos = scpi_context.param_list.lex_state.buffer;
+    SCPI_Parameter(&scpi_context, &param, TRUE);
+    CU_ASSERT_EQUAL(SCPI_ExprNumericListToRangeSet(&scpi_context, &param, &set), SCPI_EXPR_ERROR);
+    SCPI_ErrorPop(&scpi_context, &errCode);
+    CU_ASSERT_EQUAL(errCode.error_code, SCPI_ERROR_TOO_MUCH_DATA);
+}
+
 
 #define TEST_ParamNumber(data, mandatory, expected_special, expected_tag, expected_value, expected_unit, expected_base, expected_result, expected_error_code) \
 {                                                                                       \
@@ -1098,6 +1362,57 @@ static void testParamNumber(void) {
     TEST_ParamNumber("infinity", TRUE, TRUE, SCPI_NUM_INF, 0, SCPI_UNIT_NONE, 10, TRUE, 0);
     TEST_ParamNumber("minc", TRUE, TRUE, SCPI_NUM_NUMBER, 0, SCPI_UNIT_NONE, 10, FALSE, SCPI_ERROR_ILLEGAL_PARAMETER_VALUE);
     TEST_ParamNumber("100 xyz", TRUE, FALSE, SCPI_NUM_NUMBER, 100, SCPI_UNIT_NONE, 10, FALSE, SCPI_ERROR_INVALID_SUFFIX);
+    TEST_ParamNumber("1 kHz", TRUE, FALSE, SCPI_NUM_NUMBER, 1000, SCPI_UNIT_HERTZ, 10, TRUE, 0);
+    TEST_ParamNumber("1.5 Ghz", TRUE, FALSE, SCPI_NUM_NUMBER, 1.5e9, SCPI_UNIT_HERTZ, 10, TRUE, 0);
+    TEST_ParamNumber("2 mohm", TRUE, FALSE, SCPI_NUM_NUMBER, 2e6, SCPI_UNIT_OHM, 10, TRUE, 0);
+    TEST_ParamNumber("5 kohmx", TRUE, FALSE, SCPI_NUM_NUMBER, 5, SCPI_UNIT_NONE, 10, FALSE, SCPI_ERROR_INVALID_SUFFIX);
+}
+
+#define TEST_ParamNumberInt64Scaled(data, exponent, expected_special, expected_tag, expected_value, expected_unit, expected_result, expected_error_code) \
+{                                                                                       \
+    scpi_number_scaled_t value;                                                         \
+    scpi_bool_t result;                                                                 \
+    scpi_error_t errCode;                                                               \
+                                                                                        \
+    SCPI_CoreCls(&scpi_context);                                                        \
+    scpi_context.input_count = 0;                                                       \
+    scpi_context.param_list.lex_state.buffer = data;                                    \
+    scpi_context.param_list.lex_state.len = strlen(scpi_context.param_list.lex_state.buffer);\
+    scpi_context.param_list.lex_state.pos = scpi_context.param_list.lex_state.buffer;   \
+    result = SCPI_ParamNumberInt64Scaled(&scpi_context, scpi_special_numbers_def, &value, exponent, TRUE);\
+                                                                                        \
+    SCPI_ErrorPop(&scpi_context, &errCode);                                             \
+    CU_ASSERT_EQUAL(result, expected_result);                                           \
+    if (expected_result) {                                                              \
+        CU_ASSERT_EQUAL(value.special, expected_special);                               \
+        if (value.special) CU_ASSERT_EQUAL(value.content.tag, expected_tag);            \
+        if (!value.special) CU_ASSERT_EQUAL(value.content.value, expected_value);       \
+        CU_ASSERT_EQUAL(value.unit, expected_unit);                                     \
+    }                                                                                   \
+    CU_ASSERT_EQUAL(errCode.error_code, expected_error_code);                           \
+}
+
+static void testParamNumberInt64Scaled(void) {
+    TEST_ParamNumberInt64Scaled("1", 0, FALSE, SCPI_NUM_NUMBER, 1, SCPI_UNIT_NONE, TRUE, 0);
+    TEST_ParamNumberInt64Scaled("-12", 0, FALSE, SCPI_NUM_NUMBER, -12, SCPI_UNIT_NONE, TRUE, 0);
+    TEST_ParamNumberInt64Scaled("#H20", 0, FALSE, SCPI_NUM_NUMBER, 32, SCPI_UNIT_NONE, TRUE, 0);
+    TEST_ParamNumberInt64Scaled("#H20", -3, FALSE, SCPI_NUM_NUMBER, 32000, SCPI_UNIT_NONE, TRUE, 0);
+    TEST_ParamNumberInt64Scaled("868.05 MHz", 0, FALSE, SCPI_NUM_NUMBER, 868050000, SCPI_UNIT_HERTZ, TRUE, 0);
+    TEST_ParamNumberInt64Scaled("868.15MHZ", 3, FALSE, SCPI_NUM_NUMBER, 868150, SCPI_UNIT_HERTZ, TRUE, 0);
+    TEST_ParamNumberInt64Scaled("868250 kHz", 0, FALSE, SCPI_NUM_NUMBER, 868250000, SCPI_UNIT_HERTZ, TRUE, 0);
+    TEST_ParamNumberInt64Scaled("8.6805e8", 0, FALSE, SCPI_NUM_NUMBER, 868050000, SCPI_UNIT_NONE, TRUE, 0);
+    TEST_ParamNumberInt64Scaled("1.2mV", -6, FALSE, SCPI_NUM_NUMBER, 1200, SCPI_UNIT_VOLT, TRUE, 0);
+    TEST_ParamNumberInt64Scaled("-3.5 DBM", -2, FALSE, SCPI_NUM_NUMBER, -350, SCPI_UNIT_DBM, TRUE, 0);
+    TEST_ParamNumberInt64Scaled("0.5", 0, FALSE, SCPI_NUM_NUMBER, 1, SCPI_UNIT_NONE, TRUE, 0);
+    TEST_ParamNumberInt64Scaled("-0.5", 0, FALSE, SCPI_NUM_NUMBER, -1, SCPI_UNIT_NONE, TRUE, 0);
+    TEST_ParamNumberInt64Scaled("0.49", 0, FALSE, SCPI_NUM_NUMBER, 0, SCPI_UNIT_NONE, TRUE, 0);
+    TEST_ParamNumberInt64Scaled("9223372036854775807", 0, FALSE, SCPI_NUM_NUMBER, INT64_MAX, SCPI_UNIT_NONE, TRUE, 0);
+    TEST_ParamNumberInt64Scaled("-9223372036854775808", 0, FALSE, SCPI_NUM_NUMBER, INT64_MIN, SCPI_UNIT_NONE, TRUE, 0);
+    TEST_ParamNumberInt64Scaled("9223372036854775808", 0, FALSE, SCPI_NUM_NUMBER, 0, SCPI_UNIT_NONE, FALSE, SCPI_ERROR_DATA_OUT_OF_RANGE);
+    TEST_ParamNumberInt64Scaled("1e30", 0, FALSE, SCPI_NUM_NUMBER, 0, SCPI_UNIT_NONE, FALSE, SCPI_ERROR_DATA_OUT_OF_RANGE);
+    TEST_ParamNumberInt64Scaled("1e-30", 0, FALSE, SCPI_NUM_NUMBER, 0, SCPI_UNIT_NONE, TRUE, 0);
+    TEST_ParamNumberInt64Scaled("max", 0, TRUE, SCPI_NUM_MAX, 0, SCPI_UNIT_NONE, TRUE, 0);
+    TEST_ParamNumberInt64Scaled("100 xyz", 0, FALSE, SCPI_NUM_NUMBER, 100, SCPI_UNIT_NONE, FALSE, SCPI_ERROR_INVALID_SUFFIX);
 }
 
 #define TEST_Result(func, value, expected_result) \
@@ -1303,6 +1618,20 @@ static void testResultArbitraryBlock(void) {
     TEST_Result(ArbitraryBlockString, "a\r\n", "#13a\r\n");
     TEST_Result(ArbitraryBlockString, "X1234567890", "#211X1234567890");
     TEST_Result(ArbitraryBlockString, "X1234567890\x80x", "#213X1234567890\x80x");
+
+    scpi_interface.write_vector = SCPI_WriteVector;
+    TEST_Result(ArbitraryBlockString, "a", "#11a");
+    TEST_Result(ArbitraryBlockString, "", "#10");
+    TEST_Result(ArbitraryBlockString, "X1234567890\x80x", "#213X1234567890\x80x");
+    {
+        static const char payload[] = "0123456789";
+        output_buffer_clear();
+        SCPI_ResultArbitraryBlock(&scpi_context, payload, 10);
+        CU_ASSERT_EQUAL(output_buffer_writes, 1);
+        CU_ASSERT(write_vector_payload == payload);
+        CU_ASSERT_EQUAL(scpi_context.arbitrary_reminding, 0);
+    }
+    scpi_interface.write_vector = NULL;
 }
 
 static void testResultArray(void) {
@@ -1393,6 +1722,83 @@ static void testResultArray(void) {
 
 #define _countof(a) (sizeof(a)/sizeof(*(a)))
 
+static void testResultArrayLarge(void) {
+    uint16_t uint16_arr[1500];
+    uint64_t uint64_arr[300];
+    scpi_array_format_t swapped = (SCPI_GetNativeFormat() == SCPI_FORMAT_NORMAL) ? SCPI_FORMAT_SWAPPED : SCPI_FORMAT_NORMAL;
+    size_t i;
+    size_t result;
+    scpi_bool_t match;
+
+    for (i = 0; i < _countof(uint16_arr); i++) {
+        uint16_arr[i] = (uint16_t) (i * 0x0101 + 0x0102);
+    }
+
+    output_buffer_clear();
+    result = SCPI_ResultArrayUInt16(&scpi_context, uint16_arr, _countof(uint16_arr), swapped);
+    CU_ASSERT_EQUAL(result, 6 + sizeof (uint16_arr));
+    CU_ASSERT_EQUAL(memcmp(output_buffer, "#43000", 6), 0);
+    CU_ASSERT(output_buffer_writes <= 2 + sizeof (uint16_arr) / 8);
+    match = TRUE;
+    for (i = 0; i < _countof(uint16_arr); i++) {
+        uint16_t val;
+        memcpy(&val, output_buffer + 6 + i * sizeof (val), sizeof (val));
+        match &= (val == SCPI_Swap16(uint16_arr[i]));
+    }
+    CU_ASSERT_TRUE(match);
+
+    for (i = 0; i < _countof(uint64_arr); i++) {
+        uint64_arr[i] = i * 0x0101010101010101ULL + 0x0102030405060708ULL;
+    }
+
+    output_buffer_clear();
+    result = SCPI_ResultArrayUInt64(&scpi_context, uint64_arr, _countof(uint64_arr), swapped);
+    CU_ASSERT_EQUAL(result, 6 + sizeof (uint64_arr));
+    CU_ASSERT_EQUAL(memcmp(output_buffer, "#42400", 6), 0);
+    match = TRUE;
+    for (i = 0; i < _countof(uint64_arr); i++) {
+        uint64_t val;
+        memcpy(&val, output_buffer + 6 + i * sizeof (val), sizeof (val));
+        match &= (val == SCPI_Swap64(uint64_arr[i]));
+    }
+    CU_ASSERT_TRUE(match);
+
+    {
+        static char serial[sizeof (output_buffer)];
+        double double_arr[150];
+        size_t serial_len;
+
+        for (i = 0; i < _countof(double_arr); i++) {
+            double_arr[i] = (i % 3) ? -1.0 / (double) (i + 1) : (double) i * 1000.0;
+        }
+
+        output_buffer_clear();
+        scpi_context.output_count = 0;
+        for (i = 0; i < _countof(double_arr); i++) {
+            SCPI_ResultDouble(&scpi_context, double_arr[i]);
+        }
+        serial_len = output_buffer_pos;
+        memcpy(serial, output_buffer, serial_len);
+
+        output_buffer_clear();
+        scpi_context.output_count = 0;
+        result = SCPI_ResultArrayDouble(&scpi_context, double_arr, _countof(double_arr), SCPI_FORMAT_ASCII);
+        CU_ASSERT_EQUAL(result, serial_len);
+        CU_ASSERT_EQUAL(output_buffer_pos, serial_len);
+        CU_ASSERT_EQUAL(memcmp(output_buffer, serial, serial_len), 0);
+        CU_ASSERT_EQUAL(scpi_context.output_count, _countof(double_arr));
+        CU_ASSERT(output_buffer_writes < _countof(double_arr) / 10);
+
+        /* delimiter before first element if there is other result */
+        output_buffer_clear();
+        SCPI_ResultArrayDouble(&scpi_context, double_arr, 2, SCPI_FORMAT_ASCII);
+        CU_ASSERT_STRING_EQUAL(output_buffer, ",0,-0.5");
+        scpi_context.output_count = 0;
+    }
+    output_buffer_clear();
+}
+
+
 #define TEST_ParamArrayDouble(T, func, data, mandatory, _expected_value, expected_result, expected_error_code) \
 {                                                                                       \
     T value[10];                                                                        \
@@ -1473,6 +1879,56 @@ static void testParamArray(void) {
     TEST_ParamArrayInt(uint64_t, SCPI_ParamArrayUInt64, "1, 2, 3", TRUE, (1, 2, 3), TRUE, SCPI_ERROR_NO_ERROR);
     TEST_ParamArrayInt(uint64_t, SCPI_ParamArrayUInt64, "", TRUE, (0), FALSE, SCPI_ERROR_MISSING_PARAMETER);
     TEST_ParamArrayInt(uint64_t, SCPI_ParamArrayUInt64, "1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11", TRUE, (1, 2, 3, 4, 5, 6, 7, 8, 9, 10), TRUE, SCPI_ERROR_NO_ERROR);
+
+    /* plain decimal elements mixed with elements for the generic path */
+    TEST_ParamArrayInt(int32_t, SCPI_ParamArrayInt32, "-1,+2 ,#H10, 1234567890, 3.7", TRUE, (-1, 2, 16, 1234567890, 3), TRUE, SCPI_ERROR_NO_ERROR);
+    TEST_ParamArrayInt(uint32_t, SCPI_ParamArrayUInt32, "4294967295, 7", TRUE, (4294967295UL, 7), TRUE, SCPI_ERROR_NO_ERROR);
+    TEST_ParamArrayInt(int64_t, SCPI_ParamArrayInt64, "-9223372036854775807, 12", TRUE, (-9223372036854775807LL, 12), TRUE, SCPI_ERROR_NO_ERROR);
+    TEST_ParamArrayInt(int32_t, SCPI_ParamArrayInt32, "1, 2 V", TRUE, (1), TRUE, SCPI_ERROR_SUFFIX_NOT_ALLOWED);
+    TEST_ParamArrayInt(int32_t, SCPI_ParamArrayInt32, "1 2", TRUE, (1), TRUE, SCPI_ERROR_INVALID_SEPARATOR);
+    TEST_ParamArrayInt(int32_t, SCPI_ParamArrayInt32, "1,,2", TRUE, (1), TRUE, SCPI_ERROR_INVALID_STRING_DATA);
+    TEST_ParamArrayDouble(double, SCPI_ParamArrayDouble, "0.5, -2.25, 1e3, 1.5 , .5", TRUE, (0.5, -2.25, 1000, 1.5, 0.5), TRUE, SCPI_ERROR_NO_ERROR);
+    TEST_ParamArrayDouble(float, SCPI_ParamArrayFloat, "0.1, 12345.67, 1.", TRUE, (0.1, 12345.67, 1), TRUE, SCPI_ERROR_NO_ERROR);
+}
+
+static void testParamArrayExact(void) {
+    char data[1024];
+    size_t len = 0;
+    double dvalues[64];
+    float fvalues[64];
+    size_t o_count;
+    size_t i;
+    const char * p;
+    char * end;
+    scpi_bool_t match;
+    uint32_t seed = 12345;
+
+    for (i = 0; i < 64; i++) {
+        seed = seed * 1103515245u + 12345u;
+        len += snprintf(data + len, sizeof (data) - len, "%s%s%u.%0*u", i ? "," : "",
+                (seed & 0x100) ? "-" : "", (unsigned) (seed >> 16) % 1000, (int) (1 + (seed >> 8) % 6), (unsigned) (seed >> 12) % 100000);
+    }
+
+    SCPI_CoreCls(&scpi_context);
+    scpi_context.input_count = 0;
+    scpi_context.param_list.lex_state.buffer = data;
+    scpi_context.param_list.lex_state.len = len;
+    scpi_context.param_list.lex_state.pos = data;
+    CU_ASSERT_TRUE(SCPI_ParamArrayDouble(&scpi_context, dvalues, 64, &o_count, SCPI_FORMAT_ASCII, TRUE));
+    CU_ASSERT_EQUAL(o_count, 64);
+
+    scpi_context.input_count = 0;
+    scpi_context.param_list.lex_state.pos = data;
+    CU_ASSERT_TRUE(SCPI_ParamArrayFloat(&scpi_context, fvalues, 64, &o_count, SCPI_FORMAT_ASCII, TRUE));
+    CU_ASSERT_EQUAL(o_count, 64);
+
+    match = TRUE;
+    for (i = 0, p = data; i < 64; i++) {
+        match &= (strtod(p, NULL) == dvalues[i]);
+        match &= (strtof(p, &end) == fvalues[i]);
+        p = end + 1;
+    }
+    CU_ASSERT_TRUE(match);
 }
 
 static void testNumberToStr(void) {
@@ -1584,6 +2040,51 @@ static void testErrorQueue(void) {
     SCPI_ErrorClear(&scpi_context);
 }
 
+static void testErrorQueueISR(void) {
+#if USE_ERROR_ISR_QUEUE
+    scpi_error_t val;
+    int i;
+
+    SCPI_ErrorClear(&scpi_context);
+    SCPI_RegSet(&scpi_context, SCPI_REG_ESR, 0);
+    scpi_context.cmd_error = FALSE;
+
+    CU_ASSERT_TRUE(SCPI_ErrorPushFromISR(&scpi_context, SCPI_ERROR_COMMAND));
+    CU_ASSERT_TRUE(SCPI_ErrorPushFromISR(&scpi_context, -2));
+    CU_ASSERT_EQUAL(SCPI_RegGet(&scpi_context, SCPI_REG_ESR), 0);
+    CU_ASSERT_EQUAL(SCPI_ErrorCount(&scpi_context), 2);
+    CU_ASSERT_EQUAL(SCPI_RegGet(&scpi_context, SCPI_REG_ESR) & ESR_CER, ESR_CER);
+    CU_ASSERT_FALSE(scpi_context.cmd_error);
+
+    /* pushed from ISR while the queue already has errors */
+    CU_ASSERT_TRUE(SCPI_ErrorPushFromISR(&scpi_context, -3));
+    SCPI_ErrorPop(&scpi_context, &val);
+    CU_ASSERT_EQUAL(val.error_code, SCPI_ERROR_COMMAND);
+    SCPI_ErrorPop(&scpi_context, &val);
+    CU_ASSERT_EQUAL(val.error_code, -2);
+    SCPI_ErrorPop(&scpi_context, &val);
+    CU_ASSERT_EQUAL(val.error_code, -3);
+    SCPI_ErrorPop(&scpi_context, &val);
+    CU_ASSERT_EQUAL(val.error_code, 0);
+
+    /* ISR ring overflow is reported as queue overflow */
+    for (i = 0; i < SCPI_ERROR_ISR_QUEUE_SIZE; i++) {
+        CU_ASSERT_TRUE(SCPI_ErrorPushFromISR(&scpi_context, -10 - i));
+    }
+    CU_ASSERT_FALSE(SCPI_ErrorPushFromISR(&scpi_context, -1));
+    SCPI_ErrorFlushISR(&scpi_context);
+    SCPI_ErrorPop(&scpi_context, &val);
+    CU_ASSERT_EQUAL(val.error_code, -10);
+    CU_ASSERT_EQUAL(SCPI_ErrorCount(&scpi_context), 3);
+
+    SCPI_ErrorClear(&scpi_context);
+    CU_ASSERT_TRUE(SCPI_ErrorPushFromISR(&scpi_context, -4));
+    SCPI_ErrorClear(&scpi_context);
+    CU_ASSERT_EQUAL(SCPI_ErrorCount(&scpi_context), 0);
+    SCPI_RegSet(&scpi_context, SCPI_REG_ESR, 0);
+#endif
+}
+
 #define TEST_INCOMPLETE_ARB(_val, _part_len) do {\
     double val = _val;\
     char command_text[] = "SAMple #18[DOUBLE]\r";\
@@ -1732,13 +2233,20 @@ int main() {
             || (NULL == CU_add_test(pSuite, "SCPI_ParamArbitraryBlock", testSCPI_ParamArbitraryBlock))
             || (NULL == CU_add_test(pSuite, "SCPI_ParamBool", testSCPI_ParamBool))
             || (NULL == CU_add_test(pSuite, "SCPI_ParamChoice", testSCPI_ParamChoice))
+#if USE_CHOICE_INDEX
+            || (NULL == CU_add_test(pSuite, "SCPI_ParamChoiceIndex", testSCPI_ParamChoiceIndex))
+#endif
             || (NULL == CU_add_test(pSuite, "Commands handling", testCommandsHandling))
             || (NULL == CU_add_test(pSuite, "Error handling", testErrorHandling))
             || (NULL == CU_add_test(pSuite, "Device dependent error handling", testErrorHandlingDeviceDependent))
             || (NULL == CU_add_test(pSuite, "IEEE 488.2 Mandatory commands", testIEEE4882))
             || (NULL == CU_add_test(pSuite, "Numeric list", testNumericList))
             || (NULL == CU_add_test(pSuite, "Channel list", testChannelList))
+            || (NULL == CU_add_test(pSuite, "Expression list iterator", testExprListIterator))
+            || (NULL == CU_add_test(pSuite, "Expression list to array", testExprListToArray))
+            || (NULL == CU_add_test(pSuite, "Expression range set", testExprRangeSet))
             || (NULL == CU_add_test(pSuite, "SCPI_ParamNumber", testParamNumber))
+            || (NULL == CU_add_test(pSuite, "SCPI_ParamNumberInt64Scaled", testParamNumberInt64Scaled))
             || (NULL == CU_add_test(pSuite, "SCPI_ResultInt8", testResultInt8))
             || (NULL == CU_add_test(pSuite, "SCPI_ResultUInt8", testResultUInt8))
             || (NULL == CU_add_test(pSuite, "SCPI_ResultInt16", testResultInt16))
@@ -1754,9 +2262,12 @@ int main() {
             || (NULL == CU_add_test(pSuite, "SCPI_ResultText", testResultText))
             || (NULL == CU_add_test(pSuite, "SCPI_ResultArbitraryBlock", testResultArbitraryBlock))
             || (NULL == CU_add_test(pSuite, "SCPI_ResultArray", testResultArray))
+            || (NULL == CU_add_test(pSuite, "SCPI_ResultArray large", testResultArrayLarge))
             || (NULL == CU_add_test(pSuite, "SCPI_ParamArray", testParamArray))
+            || (NULL == CU_add_test(pSuite, "SCPI_ParamArray exact", testParamArrayExact))
             || (NULL == CU_add_test(pSuite, "SCPI_NumberToStr", testNumberToStr))
             || (NULL == CU_add_test(pSuite, "SCPI_ErrorQueue", testErrorQueue))
+            || (NULL == CU_add_test(pSuite, "SCPI_ErrorQueue ISR", testErrorQueueISR))
             || (NULL == CU_add_test(pSuite, "Incomplete arbitrary parameter", testIncompleteArbitraryParameter))
             || (NULL == CU_add_test(pSuite, "Incomplete text parameter", testIncompleteTextParameter))
             ) {
@@ -471,6 +471,17 @@ static void test_compareStr() {
 
     CU_ASSERT_FALSE(compareStr("abcd", 1, "efgh", 1));
     CU_ASSERT_FALSE(compareStr("ABCD", 4, "abcd", 3));
+    CU_ASSERT_FALSE(compareStr("A:B", 3, "a;b", 3));
+    CU_ASSERT_FALSE(compareStr("@", 1, "`", 1));
+}
+
+static void test_strToUpper() {
+    char str[] = "syst:Err?1 *idn";
+
+    strToUpper(str, 10);
+    CU_ASSERT_STRING_EQUAL(str, "SYST:ERR?1 *idn");
+    strToUpper(str, strlen(str));
+    CU_ASSERT_STRING_EQUAL(str, "SYST:ERR?1 *IDN");
 }
 
 static void test_compareStrAndNum() {
@@ -769,7 +780,106 @@ static void test_swap(void) {
     TEST_SWAP(64, 0x123456789ABCDEF0ull, 0xF0DEBC9A78563412ull);
 }
 
-#if USE_DEVICE_DEPENDENT_ERROR_INFORMATION && !USE_MEMORY_ALLOCATION_FREE
+static void test_swap_array(void) {
+    static const size_t item_sizes[] = {2, 4, 8};
+    uint8_t src[8 * 41 + 1];
+    uint8_t ref[8 * 41];
+    uint8_t out[8 * 41];
+    size_t i, s, count;
+    int impl;
+
+    for (i = 0; i < sizeof (src); i++) {
+        src[i] = (uint8_t) (i * 7 + 1);
+    }
+
+    /* counts cross 16 and 32 byte blocks, unaligned source checks loadu */
+    for (s = 0; s < sizeof (item_sizes) / sizeof (item_sizes[0]); s++) {
+        for (count = 0; count <= 41; count++) {
+            memset(ref, 0, sizeof (ref));
+            CU_ASSERT_TRUE(swapArrayImpl(SCPI_SWAP_SCALAR, ref, src + 1, count, item_sizes[s]));
+            for (impl = SCPI_SWAP_SCALAR; impl <= SCPI_SWAP_AVX2; impl++) {
+                memset(out, 0, sizeof (out));
+                if (swapArrayImpl((scpi_swap_impl_t) impl, out, src + 1, count, item_sizes[s])) {
+                    CU_ASSERT_EQUAL(memcmp(ref, out, sizeof (out)), 0);
+                }
+            }
+            memset(out, 0, sizeof (out));
+            swapArray(out, src + 1, count, item_sizes[s]);
+            CU_ASSERT_EQUAL(memcmp(ref, out, sizeof (out)), 0);
+        }
+    }
+
+    /* scalar reference itself */
+    swapArrayImpl(SCPI_SWAP_SCALAR, ref, src, 1, 4);
+    CU_ASSERT_EQUAL(ref[0], src[3]);
+    CU_ASSERT_EQUAL(ref[3], src[0]);
+}
+
+#if USE_ERROR_INFO_POOL
+
+static void test_pool(void) {
+    scpi_error_info_pool_t pool;
+    char * slots[SCPI_ERROR_INFO_POOL_SIZE];
+    char long_text[SCPI_ERROR_INFO_POOL_SLOT_LENGTH + 10];
+    char * ptr;
+    int i;
+
+    scpipool_init(&pool);
+
+    CU_ASSERT_EQUAL(scpipool_strndup(&pool, NULL, 5), NULL);
+    CU_ASSERT_EQUAL(scpipool_strndup(&pool, "", 5), NULL);
+
+    ptr = scpipool_strndup(&pool, "abcdef", 3);
+    CU_ASSERT_STRING_EQUAL(ptr, "abc");
+    scpipool_free(&pool, ptr);
+
+    memset(long_text, 'x', sizeof (long_text) - 1);
+    long_text[sizeof (long_text) - 1] = '\0';
+    ptr = scpipool_strndup(&pool, long_text, sizeof (long_text));
+    CU_ASSERT_EQUAL(strlen(ptr), SCPI_ERROR_INFO_POOL_SLOT_LENGTH - 1);
+    scpipool_free(&pool, ptr);
+
+    for (i = 0; i < SCPI_ERROR_INFO_POOL_SIZE; i++) {
+        slots[i] = scpipool_strndup(&pool, "info", 4);
+        CU_ASSERT(slots[i] != NULL);
+    }
+    CU_ASSERT_EQUAL(scpipool_strndup(&pool, "full", 4), NULL);
+
+    /* freed slot is reused, others are untouched */
+    scpipool_free(&pool, slots[3]);
+    scpipool_free(&pool, NULL);
+    /* foreign pointers are rejected */
+    scpipool_free(&pool, long_text);
+    scpipool_free(&pool, slots[2] + 1);
+    CU_ASSERT_EQUAL(pool.free_count, 1);
+    ptr = scpipool_strndup(&pool, "again", 5);
+    CU_ASSERT(ptr == slots[3]);
+    CU_ASSERT_STRING_EQUAL(ptr, "again");
+    CU_ASSERT_STRING_EQUAL(slots[2], "info");
+    CU_ASSERT_STRING_EQUAL(slots[4], "info");
+
+    /* double free while other slots are allocated is ignored */
+    scpipool_free(&pool, slots[5]);
+    scpipool_free(&pool, slots[5]);
+    CU_ASSERT_EQUAL(pool.free_count, 1);
+    ptr = scpipool_strndup(&pool, "once", 4);
+    CU_ASSERT(ptr == slots[5]);
+    CU_ASSERT_EQUAL(scpipool_strndup(&pool, "twice", 5), NULL);
+    CU_ASSERT_STRING_EQUAL(slots[4], "info");
+    CU_ASSERT_STRING_EQUAL(slots[6], "info");
+
+    for (i = 0; i < SCPI_ERROR_INFO_POOL_SIZE; i++) {
+        scpipool_free(&pool, slots[i]);
+    }
+    CU_ASSERT_EQUAL(pool.free_count, SCPI_ERROR_INFO_POOL_SIZE);
+
+    /* no double free beyond pool size */
+    scpipool_free(&pool, slots[0]);
+    CU_ASSERT_EQUAL(pool.free_count, SCPI_ERROR_INFO_POOL_SIZE);
+}
+#endif
+
+#if USE_DEVICE_DEPENDENT_ERROR_INFORMATION && !USE_ERROR_INFO_POOL && !USE_MEMORY_ALLOCATION_FREE
 
 static void test_heap(void) {
 
@@ -856,11 +966,16 @@ int main() {
             || (NULL == CU_add_test(pSuite, "strToDouble", test_strToDouble))
             || (NULL == CU_add_test(pSuite, "compareStr", test_compareStr))
             || (NULL == CU_add_test(pSuite, "compareStrAndNum", test_compareStrAndNum))
+            || (NULL == CU_add_test(pSuite, "strToUpper", test_strToUpper))
             || (NULL == CU_add_test(pSuite, "matchPattern", test_matchPattern))
             || (NULL == CU_add_test(pSuite, "matchCommand", test_matchCommand))
             || (NULL == CU_add_test(pSuite, "composeCompoundCommand", test_composeCompoundCommand))
             || (NULL == CU_add_test(pSuite, "swap", test_swap))
-#if USE_DEVICE_DEPENDENT_ERROR_INFORMATION && !USE_MEMORY_ALLOCATION_FREE
+            || (NULL == CU_add_test(pSuite, "swap array", test_swap_array))
+#if USE_ERROR_INFO_POOL
+            || (NULL == CU_add_test(pSuite, "pool", test_pool))
+#endif
+#if USE_DEVICE_DEPENDENT_ERROR_INFORMATION && !USE_ERROR_INFO_POOL && !USE_MEMORY_ALLOCATION_FREE
             || (NULL == CU_add_test(pSuite, "heap", test_heap))
 #endif
             ) {
@@ -7,15 +7,28 @@
 @brief     Demo application showing how to use SCPI parser and SCPI ETSI TEST components
 */
 
+#if defined(__unix__) || defined(__APPLE__)
+#define _POSIX_C_SOURCE 200809L
+#include <poll.h>
+#include <unistd.h>
+#define INPUT_POLL 1
+#else
+#define INPUT_POLL 0
+#endif
+
 #include <stdio.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <time.h>
 #include "scpi_etsi_test.h"
 #include "scpi_etsi_test_user.h"
+#include "scpi_etsi_test_sim.h"
 
 enum {
 	// number of PHYs
 	PHY_COUNT = 1,
+	// time to wait for input character in ms, lets the parser send periodic reports meanwhile
+	INPUT_POLL_TIMEOUT = 10,
 };
 
 /// Device identification string
@@ -56,21 +69,25 @@ static uint32_t* channelList[PHY_COUNT] = {
 	(uint32_t[]){868050000,868150000,868250000},
 };
 
-// flag informing that some PER test is running (when set)
-static bool isPERTestOn;
-
-// PER test result structure declaration
-static SCPI_ETSI_TEST_PERTestResult testResult;
-
 /**
  * THIS FUNCTION IS IMPLEMENTED BY THE USER.
  *
  * Gets a single character from the input stream to be passed to the SCPI parser.
- * @return character read from the input stream
+ * @param[out] c character read from the input stream
+ * @return true when character was read, false when there is no input at the moment
  */
 bool SCPI_ETSI_TEST_USER_GetChar(char *c) {
+#if INPUT_POLL
+	struct pollfd input = { .fd = STDIN_FILENO, .events = POLLIN };
+	fflush(stdout);
+	if ((poll(&input, 1, INPUT_POLL_TIMEOUT) > 0) && (read(STDIN_FILENO, c, 1) == 1)) {
+		return true;
+	}
+	return false;
+#else
 	*c = getchar();
 	return true;
+#endif
 }
 
 /**
@@ -83,6 +100,22 @@ void SCPI_ETSI_TEST_USER_PutChar(char c) {
 	putchar(c);
 }
 
+/**
+ * THIS FUNCTION IS IMPLEMENTED BY THE USER.
+ *
+ * Gets free running millisecond counter, used to time periodic reports.
+ * @return time in ms
+ */
+uint32_t SCPI_ETSI_TEST_USER_GetTime(void) {
+#if INPUT_POLL && defined(CLOCK_MONOTONIC)
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint32_t)((uint64_t)now.tv_sec * 1000u + (uint64_t)now.tv_nsec / 1000000u);
+#else
+	return (uint32_t)((uint64_t)clock() * 1000u / CLOCKS_PER_SEC);
+#endif
+}
+
 /**
  * THIS FUNCTION IS IMPLEMENTED BY THE USER.
  *
@@ -98,84 +131,8 @@ void SCPI_ETSI_TEST_USER_Init(SCPI_ETSI_TEST_DeviceDescriptor* deviceDescriptor)
 		deviceDescriptor->phyCapabilities = phyCapabilities;
 		deviceDescriptor->phyChannelList = channelList;
 	}
-}
-
-/**
- * THIS FUNCTION IS IMPLEMENTED BY THE USER.
- *
- * Resets the device.
- */
-void SCPI_ETSI_TEST_USER_Reset(SCPI_ETSI_TEST_DeviceDescriptor* deviceDescriptor) {
-	printf("Running SCPI_ETSI_TEST_USER_Reset\n");
-}
-
-/**
- * THIS FUNCTION IS IMPLEMENTED BY THE USER.
- *
- * Sets the transceiver mode of operation
- * 0 = TRX disabled, no reception and no transmissions (OFF)
- * 1 = enable radio transmission (TX)
- * 2 = enable radio reception (RX)
- * @param[inout] deviceDescriptor pointer to the device descriptor structure
- * @param[in] mode number describing transceiver operation mode
- * @return true on success, false otherwise
- */
-bool SCPI_ETSI_TEST_USER_SetTRXMode(SCPI_ETSI_TEST_DeviceDescriptor* deviceDescriptor, uint8_t mode){
-	// configuration of transceiver using data stored in phySettings structure
-	if(mode == 0){
-		printf("TRX off\n");
-	}
-	else if(mode == 1){
-		printf("TRX enabled radio transmission (TX)\n");
-	}
-	else if(mode == 2){
-		printf("TRX enabled radio reception (RX)\n");
-	}
-	return true;
-}
-
-/**
- * THIS FUNCTION IS IMPLEMENTED BY THE USER.
- *
- * Starts Packet Error Rate (PER) test. This command is issued to the device being the source of packets in a PER test.
- * @param[inout] deviceDescriptor pointer to the device descriptor structure
- * @param[in] testID identification number of PER test
- * @return true on success, false otherwise
- */
-bool SCPI_ETSI_TEST_USER_StartPERTest(SCPI_ETSI_TEST_DeviceDescriptor* deviceDescriptor, uint32_t testID){
-	// starting PER test using data stored in phySettings structure and given testID
-	if(deviceDescriptor){
-		testResult.testID = testID;
-		testResult.totalPacketsNumber = deviceDescriptor->phySettings.perTotalPacketsNumber;
-		isPERTestOn = true;
-		return true;
-	}
-	return false;
-}
-
-/**
- * THIS FUNCTION IS IMPLEMENTED BY THE USER.
- *
- * Checks if there is an ongoing PER test.
- * @param[inout] deviceDescriptor pointer to the device descriptor structure
- * @return true when some PER test is running, false otherwise
- */
-bool SCPI_ETSI_TEST_USER_IsPERTestRunning(SCPI_ETSI_TEST_DeviceDescriptor* deviceDescriptor){
-	return isPERTestOn;
-}
-
-/**
- * THIS FUNCTION IS IMPLEMENTED BY THE USER.
- *
- * Gets the result of a PER test.
- * @param[inout] deviceDescriptor pointer to the device descriptor structure
- * @return address of structure storing information about PER test result
- */
-SCPI_ETSI_TEST_PERTestResult* SCPI_ETSI_TEST_USER_GetPERTestResult(SCPI_ETSI_TEST_DeviceDescriptor* deviceDescriptor){
-	// returning address of filled per test result data structure
-	// it's not necessary to fill structure inside this method, if it has been done somewhere else
-	testResult.receivedPacketsNumber = 973;
-	return &testResult;
+	// radio hooks (Reset, SetTRXMode, PER test) are served by the simulated transceiver
+	SCPI_ETSI_TEST_SIM_Init(NULL);
 }
 
 int main(void) {
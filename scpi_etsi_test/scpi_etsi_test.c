@@ -11,6 +11,7 @@
 #include <string.h>
 #include <stdint.h>
 #include <inttypes.h>
+#include <math.h>
 #include "scpi_etsi_test.h"
 #include "scpi.h"
 #include "scpi_etsi_test_user.h"
@@ -23,6 +24,7 @@ enum {
 	INT16_BUFF_SIZE = 7,
 	UINT32_BUFF_SIZE = 11,
 	INT32_BUFF_SIZE = 12,
+	INT64_BUFF_SIZE = 21,
 	STRING_BUFF_SIZE = 256,
 };
 
@@ -40,6 +42,58 @@ enum {
 #define SCPI_ERROR_QUEUE_SIZE 17
 #endif
 
+#ifndef SCPI_ETSI_TEST_CHANNEL_INDEX_LENGTH
+#define SCPI_ETSI_TEST_CHANNEL_INDEX_LENGTH 256
+#endif
+
+// policies of matching requested frequency with channel frequency
+enum {
+	FREQUENCY_MATCH_EXACT = 0,
+	FREQUENCY_MATCH_NEAREST = 1,
+};
+
+// response data formats selected by FORMat:DATA
+enum {
+	DATA_FORMAT_ASCII = 0,		// decimal numbers separated by comma
+	DATA_FORMAT_INTEGER = 1,	// definite length block of 64 bit signed integers
+	DATA_FORMAT_REAL = 2,		// definite length block of 64 bit IEEE 754 numbers
+};
+
+// PER limit and its confidence level (in ppm) a PER test was started with, its verdict is decided against them
+typedef struct{
+	uint32_t perLimit;
+	uint32_t perConfidence;
+}SCPI_ETSI_TEST_PERDecision;
+
+// seed of PER test packet outcomes after *RST or SETtings:PER:SEED without value
+#define SCPI_ETSI_TEST_DEFAULT_PER_SEED 0
+
+// PER limit and its confidence level (in ppm) after *RST, SETtings:PHY or command without value
+#define SCPI_ETSI_TEST_DEFAULT_PER_LIMIT 0
+#define SCPI_ETSI_TEST_DEFAULT_PER_CONFIDENCE 950000
+#define SCPI_ETSI_TEST_PPM 1000000
+
+// number of power and channel points of PER:SWEep? run and sent in one batch
+#define SCPI_ETSI_TEST_PER_SWEEP_BATCH_POINTS 512
+
+// number of PER test slots followed by progress reports and completion notifications
+#define SCPI_ETSI_TEST_PER_MAX_SLOT_BITS 32
+
+// number of PER test results kept in history, power of two up to 16384
+#ifndef SCPI_ETSI_TEST_PER_HISTORY_LENGTH
+#define SCPI_ETSI_TEST_PER_HISTORY_LENGTH 1024
+#endif
+#if (SCPI_ETSI_TEST_PER_HISTORY_LENGTH & (SCPI_ETSI_TEST_PER_HISTORY_LENGTH - 1)) || (SCPI_ETSI_TEST_PER_HISTORY_LENGTH > 16384)
+#error "SCPI_ETSI_TEST_PER_HISTORY_LENGTH must be power of two up to 16384"
+#endif
+// size of test ID hash table of PER test result history, at most half of it is used
+#define SCPI_ETSI_TEST_PER_HISTORY_HASH_SIZE (2 * SCPI_ETSI_TEST_PER_HISTORY_LENGTH)
+// unused entry of PER test result history hash table
+#define SCPI_ETSI_TEST_PER_HISTORY_EMPTY UINT16_MAX
+
+// number of values packed at once into binary block
+#define SCPI_ETSI_TEST_BLOCK_CHUNK 16
+
 // declaration of functions called when given SCPI command appears
 scpi_result_t SCPI_ETSI_TEST_GetIDN(scpi_t* context);
 scpi_result_t SCPI_ETSI_TEST_Reset(scpi_t* context);
@@ -65,6 +119,8 @@ scpi_result_t SCPI_ETSI_TEST_SetPhy(scpi_t* context);
 scpi_result_t SCPI_ETSI_TEST_GetSelectedPhy(scpi_t* context);
 scpi_result_t SCPI_ETSI_TEST_SetChannel(scpi_t* context);
 scpi_result_t SCPI_ETSI_TEST_GetSelectedChannel(scpi_t* context);
+scpi_result_t SCPI_ETSI_TEST_SetFrequency(scpi_t* context);
+scpi_result_t SCPI_ETSI_TEST_GetSelectedFrequency(scpi_t* context);
 scpi_result_t SCPI_ETSI_TEST_SetSignal(scpi_t* context);
 scpi_result_t SCPI_ETSI_TEST_GetSelectedSignal(scpi_t* context);
 scpi_result_t SCPI_ETSI_TEST_SetPower(scpi_t* context);
@@ -75,10 +131,28 @@ scpi_result_t SCPI_ETSI_TEST_SetPERTotalPackets(scpi_t* context);
 scpi_result_t SCPI_ETSI_TEST_GetSelectedPERTotalPackets(scpi_t* context);
 scpi_result_t SCPI_ETSI_TEST_SetPERPacketLength(scpi_t* context);
 scpi_result_t SCPI_ETSI_TEST_GetSelectedPERPacketLength(scpi_t* context);
+scpi_result_t SCPI_ETSI_TEST_SetPERSeed(scpi_t* context);
+scpi_result_t SCPI_ETSI_TEST_GetSelectedPERSeed(scpi_t* context);
+scpi_result_t SCPI_ETSI_TEST_SetPERLimit(scpi_t* context);
+scpi_result_t SCPI_ETSI_TEST_GetSelectedPERLimit(scpi_t* context);
+scpi_result_t SCPI_ETSI_TEST_SetPERConfidence(scpi_t* context);
+scpi_result_t SCPI_ETSI_TEST_GetSelectedPERConfidence(scpi_t* context);
 scpi_result_t SCPI_ETSI_TEST_SetTRXMode(scpi_t* context);
 scpi_result_t SCPI_ETSI_TEST_StartPERTest(scpi_t* context);
 scpi_result_t SCPI_ETSI_TEST_IsPERTestRunning(scpi_t* context);
 scpi_result_t SCPI_ETSI_TEST_GetPERTestResult(scpi_t* context);
+scpi_result_t SCPI_ETSI_TEST_GetPERTestResultRange(scpi_t* context);
+scpi_result_t SCPI_ETSI_TEST_ClearPERTestResults(scpi_t* context);
+scpi_result_t SCPI_ETSI_TEST_GetPERSweep(scpi_t* context);
+scpi_result_t SCPI_ETSI_TEST_GetSensitivity(scpi_t* context);
+scpi_result_t SCPI_ETSI_TEST_GetPERTestProgress(scpi_t* context);
+scpi_result_t SCPI_ETSI_TEST_WaitPERTest(scpi_t* context);
+scpi_result_t SCPI_ETSI_TEST_SetPERProgressPush(scpi_t* context);
+scpi_result_t SCPI_ETSI_TEST_GetPERProgressPush(scpi_t* context);
+scpi_result_t SCPI_ETSI_TEST_SetDataFormat(scpi_t* context);
+scpi_result_t SCPI_ETSI_TEST_GetDataFormat(scpi_t* context);
+scpi_result_t SCPI_ETSI_TEST_SetByteOrder(scpi_t* context);
+scpi_result_t SCPI_ETSI_TEST_GetByteOrder(scpi_t* context);
 
 static scpi_error_t scpiErrorBuffer[SCPI_ERROR_QUEUE_SIZE];
 static char scpiInputBuffer[SCPI_INPUT_BUFFER_LENGTH];
@@ -110,6 +184,8 @@ static const scpi_command_t scpiCommands[] = {
 										{ .pattern = "SETtings:PHY?",					.callback = SCPI_ETSI_TEST_GetSelectedPhy, },
 										{ .pattern = "SETtings:CHANnel",				.callback = SCPI_ETSI_TEST_SetChannel, },
 										{ .pattern = "SETtings:CHANnel?",				.callback = SCPI_ETSI_TEST_GetSelectedChannel, },
+										{ .pattern = "SETtings:FREQuency",				.callback = SCPI_ETSI_TEST_SetFrequency, },
+										{ .pattern = "SETtings:FREQuency?",				.callback = SCPI_ETSI_TEST_GetSelectedFrequency, },
 										{ .pattern = "SETtings:SIGnal",					.callback = SCPI_ETSI_TEST_SetSignal, },
 										{ .pattern = "SETtings:SIGnal?",				.callback = SCPI_ETSI_TEST_GetSelectedSignal, },
 										{ .pattern = "SETtings:POWer",					.callback = SCPI_ETSI_TEST_SetPower, },
@@ -120,21 +196,817 @@ static const scpi_command_t scpiCommands[] = {
 										{ .pattern = "SETtings:PER:TOTALpackets?",		.callback = SCPI_ETSI_TEST_GetSelectedPERTotalPackets, },
 										{ .pattern = "SETtings:PER:PCKTLENgth",			.callback = SCPI_ETSI_TEST_SetPERPacketLength, },
 										{ .pattern = "SETtings:PER:PCKTLENgth?",		.callback = SCPI_ETSI_TEST_GetSelectedPERPacketLength, },
+										{ .pattern = "SETtings:PER:SEED",				.callback = SCPI_ETSI_TEST_SetPERSeed, },
+										{ .pattern = "SETtings:PER:SEED?",				.callback = SCPI_ETSI_TEST_GetSelectedPERSeed, },
+										{ .pattern = "SETtings:PER:LIMit",				.callback = SCPI_ETSI_TEST_SetPERLimit, },
+										{ .pattern = "SETtings:PER:LIMit?",				.callback = SCPI_ETSI_TEST_GetSelectedPERLimit, },
+										{ .pattern = "SETtings:PER:CONFidence",			.callback = SCPI_ETSI_TEST_SetPERConfidence, },
+										{ .pattern = "SETtings:PER:CONFidence?",		.callback = SCPI_ETSI_TEST_GetSelectedPERConfidence, },
 										{ .pattern = "TRXmode",							.callback = SCPI_ETSI_TEST_SetTRXMode, },
 										{ .pattern = "PER",								.callback = SCPI_ETSI_TEST_StartPERTest, },
-										{ .pattern = "PER?",							.callback = SCPI_ETSI_TEST_IsPERTestRunning, },
-										{ .pattern = "PERRESULT?",						.callback = SCPI_ETSI_TEST_GetPERTestResult, },
+										{ .pattern = "PER#?",							.callback = SCPI_ETSI_TEST_IsPERTestRunning, },
+										{ .pattern = "PERRESULT#?",						.callback = SCPI_ETSI_TEST_GetPERTestResult, },
+										{ .pattern = "PERRESULT:RANGe?",				.callback = SCPI_ETSI_TEST_GetPERTestResultRange, },
+										{ .pattern = "PERRESULT:CLEar",					.callback = SCPI_ETSI_TEST_ClearPERTestResults, },
+										{ .pattern = "PER:SWEep?",						.callback = SCPI_ETSI_TEST_GetPERSweep, },
+										{ .pattern = "PER:SENSitivity?",				.callback = SCPI_ETSI_TEST_GetSensitivity, },
+										{ .pattern = "PER#:PROGress?",					.callback = SCPI_ETSI_TEST_GetPERTestProgress, },
+										{ .pattern = "PER#:WAIT?",						.callback = SCPI_ETSI_TEST_WaitPERTest, },
+										{ .pattern = "PER:PROGress:PUSH",				.callback = SCPI_ETSI_TEST_SetPERProgressPush, },
+										{ .pattern = "PER:PROGress:PUSH?",				.callback = SCPI_ETSI_TEST_GetPERProgressPush, },
+										{ .pattern = "SYSTem:ERRor[:NEXT]?",			.callback = SCPI_SystemErrorNextQ, },
+										{ .pattern = "SYSTem:ERRor:ALL?",				.callback = SCPI_SystemErrorAllQ, },
+										{ .pattern = "SYSTem:ERRor:COUNt?",				.callback = SCPI_SystemErrorCountQ, },
+										{ .pattern = "SYSTem:ERRor:STATus?",			.callback = SCPI_SystemErrorStatusQ, },
+										{ .pattern = "FORMat[:DATA]",					.callback = SCPI_ETSI_TEST_SetDataFormat, },
+										{ .pattern = "FORMat[:DATA]?",					.callback = SCPI_ETSI_TEST_GetDataFormat, },
+										{ .pattern = "FORMat:BORDer",					.callback = SCPI_ETSI_TEST_SetByteOrder, },
+										{ .pattern = "FORMat:BORDer?",					.callback = SCPI_ETSI_TEST_GetByteOrder, },
 										SCPI_CMD_LIST_END };
 
-static scpi_interface_t scpiInterface = {   .write = NULL,
+static size_t SCPI_ETSI_TEST_Write(scpi_t* context, const char* data, size_t len);
+
+static scpi_interface_t scpiInterface = {   .write = SCPI_ETSI_TEST_Write,
 											.error = NULL,
 											.reset = NULL,
 											.flush = NULL, };
 
+// frequency match policies accepted by SETtings:FREQuency
+static const scpi_choice_def_t frequencyMatchPolicies[] = {
+	{ "EXACt", FREQUENCY_MATCH_EXACT },
+	{ "NEARest", FREQUENCY_MATCH_NEAREST },
+	SCPI_CHOICE_LIST_END };
+
+// data formats accepted by FORMat:DATA
+static const scpi_choice_def_t dataFormats[] = {
+	{ "ASCii", DATA_FORMAT_ASCII },
+	{ "INTeger", DATA_FORMAT_INTEGER },
+	{ "REAL", DATA_FORMAT_REAL },
+	SCPI_CHOICE_LIST_END };
+
+// byte orders accepted by FORMat:BORDer
+static const scpi_choice_def_t byteOrders[] = {
+	{ "NORMal", SCPI_FORMAT_NORMAL },
+	{ "SWAPped", SCPI_FORMAT_SWAPPED },
+	SCPI_CHOICE_LIST_END };
+
+#if USE_CHOICE_INDEX
+// hash indexes of the choice lists above registered in the parser context
+static scpi_choice_index_t frequencyMatchPoliciesIndex;
+static scpi_choice_index_t dataFormatsIndex;
+static scpi_choice_index_t byteOrdersIndex;
+#endif
+
+// results of the current batch of PER:SWEep?
+static SCPI_ETSI_TEST_PERTestResult perSweepResults[SCPI_ETSI_TEST_PER_SWEEP_BATCH_POINTS];
+
+// interval of PER progress reports in ms (0 when disabled)
+static uint32_t perPushInterval;
+// time of the last PER progress report in ms
+static uint32_t perPushTime;
+// PER test slots whose progress is being reported, bit per slot
+static uint32_t perPushSlots;
+// PER test slots reported finished by SCPI_ETSI_TEST_PERTestFinished, bit per slot
+static volatile uint32_t perFinishedSlots;
+// PER test slots running tests started by PER command, their results are stored in history
+static uint32_t perPendingSlots;
+// PER limit settings of the last PER test started in every slot
+static SCPI_ETSI_TEST_PERDecision perSlotDecisions[SCPI_ETSI_TEST_PER_MAX_SLOT_BITS];
+
+// ring of finished PER test results, oldest result is overwritten when full
+static SCPI_ETSI_TEST_PERTestResult perHistory[SCPI_ETSI_TEST_PER_HISTORY_LENGTH];
+// PER limit settings the results in perHistory were run with, at the same positions
+static SCPI_ETSI_TEST_PERDecision perHistoryDecisions[SCPI_ETSI_TEST_PER_HISTORY_LENGTH];
+// open addressing (linear probing) hash table of perHistory positions indexed by test ID
+static uint16_t perHistoryIndex[SCPI_ETSI_TEST_PER_HISTORY_HASH_SIZE];
+// position of perHistory written next
+static uint16_t perHistoryHead;
+// number of results in perHistory
+static uint16_t perHistoryCount;
+
+// format of numeric query responses
+static int32_t dataFormat = DATA_FORMAT_ASCII;
+// byte order of binary query responses
+static int32_t byteOrder = SCPI_FORMAT_NORMAL;
+
 // device structure descriptor
 static SCPI_ETSI_TEST_DeviceDescriptor deviceDesc;
 // scpi parser handler
 static scpi_t scpiContext;
+// channel numbers of the selected PHY sorted by ascending frequency
+static uint16_t channelIndex[SCPI_ETSI_TEST_CHANNEL_INDEX_LENGTH];
+// number of valid entries in channelIndex (0 when the channel list does not fit)
+static uint16_t channelIndexCount;
+
+/**
+ *  Builds sorted channel index of given PHY used for frequency to channel number lookup.
+ *
+ *  @param[in] phy - number of PHY which channel list is indexed
+*/
+static void SCPI_ETSI_TEST_BuildChannelIndex(uint8_t phy){
+	channelIndexCount = 0;
+	if((phy < deviceDesc.phyCount) && (NULL != deviceDesc.phyChannelList)){
+		const uint32_t* channelList = deviceDesc.phyChannelList[phy];
+		const uint16_t channelCount = deviceDesc.phyCapabilities[phy].channelCount;
+		if((NULL != channelList) && (channelCount <= SCPI_ETSI_TEST_CHANNEL_INDEX_LENGTH)){
+			// insertion sort - channel lists are short and usually already sorted
+			for(uint16_t channel=0; channel < channelCount; channel++){
+				uint16_t position = channel;
+				while(position > 0 && channelList[channelIndex[position-1]] > channelList[channel]){
+					channelIndex[position] = channelIndex[position-1];
+					position--;
+				}
+				channelIndex[position] = channel;
+			}
+			channelIndexCount = channelCount;
+		}
+	}
+}
+
+/**
+ *  Finds channel of the selected PHY matching given frequency.
+ *
+ *  @param[in] frequency - requested frequency in Hz
+ *  @param[in] policy - FREQUENCY_MATCH_EXACT or FREQUENCY_MATCH_NEAREST
+ *  @param[out] channel - number of found channel
+ *  @return true when matching channel was found, false otherwise
+*/
+static bool SCPI_ETSI_TEST_FindChannelByFrequency(uint32_t frequency, int32_t policy, uint16_t* channel){
+	const uint8_t phy = deviceDesc.phySettings.phyNumber;
+	if((phy >= deviceDesc.phyCount) || (NULL == deviceDesc.phyChannelList) || (NULL == deviceDesc.phyChannelList[phy])){
+		return false;
+	}
+	const uint32_t* channelList = deviceDesc.phyChannelList[phy];
+	const uint16_t channelCount = deviceDesc.phyCapabilities[phy].channelCount;
+	if(0 == channelCount){
+		return false;
+	}
+	uint16_t best = 0;
+	uint32_t bestDistance = UINT32_MAX;
+	if(channelIndexCount == channelCount){
+		// binary search for the first channel with frequency not lower than requested one
+		uint16_t low = 0;
+		uint16_t high = channelIndexCount;
+		while(low < high){
+			const uint16_t middle = low + (high - low) / 2;
+			if(channelList[channelIndex[middle]] < frequency){
+				low = middle + 1;
+			} else{
+				high = middle;
+			}
+		}
+		// only neighbours of the insertion point can be the nearest ones
+		if(low < channelIndexCount){
+			best = channelIndex[low];
+			bestDistance = channelList[best] - frequency;
+		}
+		if((low > 0) && (frequency - channelList[channelIndex[low-1]] <= bestDistance)){
+			best = channelIndex[low-1];
+			bestDistance = frequency - channelList[best];
+		}
+	} else{
+		// channel list too long to be indexed, fall back to linear scan
+		for(uint16_t i=0; i < channelCount; i++){
+			const uint32_t distance = (channelList[i] > frequency) ? (channelList[i] - frequency) : (frequency - channelList[i]);
+			if(distance < bestDistance){
+				best = i;
+				bestDistance = distance;
+			}
+		}
+	}
+	if((FREQUENCY_MATCH_EXACT == policy) && (0 != bestDistance)){
+		return false;
+	}
+	*channel = best;
+	return true;
+}
+
+/**
+ *  Passes parser output (binary block responses) to the user's output.
+ *
+ *  @param[in] context - parser context
+ *  @param[in] data - data to send
+ *  @param[in] len - number of bytes to send
+ *  @return number of bytes sent
+*/
+static size_t SCPI_ETSI_TEST_Write(scpi_t* context, const char* data, size_t len){
+	(void)context;
+	SCPI_ETSI_TEST_Send(data, len);
+	return len;
+}
+
+/**
+ *  Starts binary block response of given number of values in selected data format.
+ *
+ *  @param[in] context - parser context
+ *  @param[in] count - number of values in the block
+*/
+static void SCPI_ETSI_TEST_SendBlockHeader(scpi_t* context, size_t count){
+	SCPI_ResultArbitraryBlockHeader(context, count * sizeof(uint64_t));
+	if(0 == count){
+		// empty block is complete right after the header
+		SCPI_ResultArbitraryBlockData(context, NULL, 0);
+	}
+}
+
+/**
+ *  Packs values into binary block in selected data format and byte order.
+ *
+ *  @param[in] context - parser context
+ *  @param[in] values - values to send
+ *  @param[in] count - number of values
+*/
+static void SCPI_ETSI_TEST_SendBlockValues(scpi_t* context, const int64_t* values, size_t count){
+	uint8_t buffer[SCPI_ETSI_TEST_BLOCK_CHUNK * sizeof(uint64_t)];
+	size_t length = 0;
+	for(size_t i=0; i < count; i++){
+		uint64_t bits = (uint64_t)values[i];
+		if(DATA_FORMAT_REAL == dataFormat){
+			const double real = (double)values[i];
+			memcpy(&bits, &real, sizeof(bits));
+		}
+		// NORMal is big endian, SWAPped is little endian regardless of the host
+		for(size_t byte=0; byte < sizeof(bits); byte++){
+			const size_t shift = (SCPI_FORMAT_NORMAL == byteOrder) ? (8 * (sizeof(bits) - 1 - byte)) : (8 * byte);
+			buffer[length++] = (uint8_t)(bits >> shift);
+		}
+		if(length == sizeof(buffer)){
+			SCPI_ResultArbitraryBlockData(context, buffer, length);
+			length = 0;
+		}
+	}
+	if(length > 0){
+		SCPI_ResultArbitraryBlockData(context, buffer, length);
+	}
+}
+
+/**
+ *  Sends numeric query response in selected data format. In ASCII format values
+ *  are separated by comma and terminated by new line character, in binary formats
+ *  they are sent as a definite length block.
+ *
+ *  @param[in] context - parser context
+ *  @param[in] values - values to send
+ *  @param[in] count - number of values
+*/
+static void SCPI_ETSI_TEST_SendNumbers(scpi_t* context, const int64_t* values, size_t count){
+	if(DATA_FORMAT_ASCII == dataFormat){
+		char buffer[INT64_BUFF_SIZE];
+		for(size_t i=0; i < count; i++){
+			snprintf(buffer, sizeof(buffer), "%"PRId64"%c", values[i], (i == count-1) ? '\n' : ',');
+			SCPI_ETSI_TEST_Send(buffer, strlen(buffer));
+		}
+	} else{
+		SCPI_ETSI_TEST_SendBlockHeader(context, count);
+		SCPI_ETSI_TEST_SendBlockValues(context, values, count);
+	}
+}
+
+/**
+ *  Sends single value numeric query response in selected data format.
+ *
+ *  @param[in] context - parser context
+ *  @param[in] value - value to send
+*/
+static void SCPI_ETSI_TEST_SendNumber(scpi_t* context, int64_t value){
+	SCPI_ETSI_TEST_SendNumbers(context, &value, 1);
+}
+
+/**
+ *  Calculates quantile of the standard normal distribution (Abramowitz and Stegun 26.2.23,
+ *  absolute error below 4.5e-4).
+ *
+ *  @param[in] probability - upper tail probability, in range (0, 0.5]
+ *  @return quantile
+*/
+static double SCPI_ETSI_TEST_GetNormalQuantile(double probability){
+	const double t = sqrt(-2.0 * log(probability));
+	return t - (2.515517 + t * (0.802853 + t * 0.010328)) / (1.0 + t * (1.432788 + t * (0.189269 + t * 0.001308)));
+}
+
+SCPI_ETSI_TEST_PERVerdict SCPI_ETSI_TEST_GetPERVerdict(const SCPI_ETSI_TEST_PhySettings* settings, uint32_t sentPackets,
+		uint32_t receivedPackets, uint32_t* lower, uint32_t* upper){
+	double low = 0.0;
+	double high = 1.0;
+	if((NULL != settings) && (sentPackets > 0) && (receivedPackets <= sentPackets)
+			&& (settings->perConfidence > 0) && (settings->perConfidence < SCPI_ETSI_TEST_PPM)){
+		const double n = sentPackets;
+		const double rate = (double)(sentPackets - receivedPackets) / n;
+		const double z = SCPI_ETSI_TEST_GetNormalQuantile((1.0 - (double)settings->perConfidence / SCPI_ETSI_TEST_PPM) / 2.0);
+		const double z2 = z * z;
+		const double center = (rate + z2 / (2.0 * n)) / (1.0 + z2 / n);
+		const double halfWidth = z / (1.0 + z2 / n) * sqrt(rate * (1.0 - rate) / n + z2 / (4.0 * n * n));
+		low = (center > halfWidth) ? (center - halfWidth) : 0.0;
+		high = (center + halfWidth < 1.0) ? (center + halfWidth) : 1.0;
+	}
+	if(NULL != lower){
+		*lower = (uint32_t)floor(low * SCPI_ETSI_TEST_PPM);
+	}
+	if(NULL != upper){
+		*upper = (uint32_t)ceil(high * SCPI_ETSI_TEST_PPM);
+	}
+	if((NULL != settings) && (0 != settings->perLimit)){
+		const double limit = (double)settings->perLimit / SCPI_ETSI_TEST_PPM;
+		if(high < limit){
+			return SCPI_ETSI_TEST_PER_PASS;
+		}
+		if(low > limit){
+			return SCPI_ETSI_TEST_PER_FAIL;
+		}
+	}
+	return SCPI_ETSI_TEST_PER_UNDECIDED;
+}
+
+/**
+ *  Gets PER test slot of given PHY and antenna. Slots are numbered by PHY, then by antenna. Every PHY
+ *  has antennaCount + 1 slots, as SETtings:ANTenna accepts antenna numbers 0 to antennaCount.
+ *
+ *  @param[in] phy - PHY number, phyCount gives the number of slots
+ *  @param[in] antenna - antenna number
+ *  @return PER test slot
+*/
+static uint16_t SCPI_ETSI_TEST_GetPERSlot(uint8_t phy, uint8_t antenna){
+	uint16_t slot = antenna;
+	for(uint8_t i=0; i < phy; i++){
+		slot += (uint16_t)(deviceDesc.phyCapabilities[i].antennaCount + 1);
+	}
+	return slot;
+}
+
+/**
+ *  Gets PER test slot of the selected PHY and antenna.
+ *
+ *  @return PER test slot
+*/
+static uint16_t SCPI_ETSI_TEST_GetSelectedPERSlot(void){
+	return SCPI_ETSI_TEST_GetPERSlot(deviceDesc.phySettings.phyNumber, deviceDesc.phySettings.antennaNumber);
+}
+
+/**
+ *  Gets PER test slot from the command suffix, the slot of the selected PHY and antenna is used
+ *  when the suffix is omitted.
+ *
+ *  @param[in] context - parser context
+ *  @param[out] slot - PER test slot
+ *  @return true on success, false when the slot does not exist
+*/
+static bool SCPI_ETSI_TEST_GetCommandPERSlot(scpi_t* context, uint16_t* slot){
+	int32_t number;
+	SCPI_CommandNumbers(context, &number, 1, -1);
+	if(number < 0){
+		*slot = SCPI_ETSI_TEST_GetSelectedPERSlot();
+		return true;
+	}
+	if(number < SCPI_ETSI_TEST_GetPERSlot(deviceDesc.phyCount, 0)){
+		*slot = (uint16_t)number;
+		return true;
+	}
+	return false;
+}
+
+/**
+ *  Gets PER limit settings selected at the moment.
+ *
+ *  @return PER limit settings
+*/
+static SCPI_ETSI_TEST_PERDecision SCPI_ETSI_TEST_GetSelectedPERDecision(void){
+	const SCPI_ETSI_TEST_PERDecision decision = { .perLimit = deviceDesc.phySettings.perLimit, .perConfidence = deviceDesc.phySettings.perConfidence };
+	return decision;
+}
+
+/**
+ *  Records the selected PER limit settings as settings of PER test just started in given slot.
+ *
+ *  @param[in] slot - PER test slot
+*/
+static void SCPI_ETSI_TEST_SetPERSlotDecision(uint16_t slot){
+	if(slot < SCPI_ETSI_TEST_PER_MAX_SLOT_BITS){
+		perSlotDecisions[slot] = SCPI_ETSI_TEST_GetSelectedPERDecision();
+	}
+}
+
+/**
+ *  Gets PER limit settings the last PER test of given slot was started with. Slots which are not
+ *  followed get the selected settings.
+ *
+ *  @param[in] slot - PER test slot
+ *  @return PER limit settings
+*/
+static SCPI_ETSI_TEST_PERDecision SCPI_ETSI_TEST_GetPERSlotDecision(uint16_t slot){
+	if(slot < SCPI_ETSI_TEST_PER_MAX_SLOT_BITS){
+		return perSlotDecisions[slot];
+	}
+	return SCPI_ETSI_TEST_GetSelectedPERDecision();
+}
+
+/**
+ *  Gets home position of test ID in PER test result history hash table (Fibonacci hashing).
+ *
+ *  @param[in] testID - identification number of PER test
+ *  @return hash table position
+*/
+static size_t SCPI_ETSI_TEST_GetPERHistoryHash(uint32_t testID){
+	return (size_t)((testID * UINT32_C(2654435761)) >> 16) & (SCPI_ETSI_TEST_PER_HISTORY_HASH_SIZE - 1);
+}
+
+/**
+ *  Finds hash table entry of test ID in PER test result history. The table is never more than
+ *  half full, so probing always ends at an unused entry.
+ *
+ *  @param[in] testID - identification number of PER test
+ *  @return entry holding position of the result, or unused entry where it belongs
+*/
+static uint16_t* SCPI_ETSI_TEST_FindPERHistoryEntry(uint32_t testID){
+	size_t i = SCPI_ETSI_TEST_GetPERHistoryHash(testID);
+	while((SCPI_ETSI_TEST_PER_HISTORY_EMPTY != perHistoryIndex[i]) && (perHistory[perHistoryIndex[i]].testID != testID)){
+		i = (i + 1) & (SCPI_ETSI_TEST_PER_HISTORY_HASH_SIZE - 1);
+	}
+	return &perHistoryIndex[i];
+}
+
+/**
+ *  Clears PER test result history.
+*/
+static void SCPI_ETSI_TEST_ClearPERHistory(void){
+	memset(perHistoryIndex, 0xFF, sizeof(perHistoryIndex));
+	perHistoryHead = 0;
+	perHistoryCount = 0;
+}
+
+/**
+ *  Removes result at given position from the hash table of PER test result history, unless
+ *  a newer result of the same test ID replaced it there. Following entries of the probe
+ *  sequence are shifted back, so no tombstones are needed.
+ *
+ *  @param[in] position - perHistory position
+*/
+static void SCPI_ETSI_TEST_RemovePERHistoryEntry(uint16_t position){
+	uint16_t* entry = SCPI_ETSI_TEST_FindPERHistoryEntry(perHistory[position].testID);
+	if(*entry != position){
+		return;
+	}
+	const size_t mask = SCPI_ETSI_TEST_PER_HISTORY_HASH_SIZE - 1;
+	size_t hole = (size_t)(entry - perHistoryIndex);
+	for(size_t i = (hole + 1) & mask; SCPI_ETSI_TEST_PER_HISTORY_EMPTY != perHistoryIndex[i]; i = (i + 1) & mask){
+		const size_t home = SCPI_ETSI_TEST_GetPERHistoryHash(perHistory[perHistoryIndex[i]].testID);
+		// entry may fill the hole when its home is not between the hole and the entry
+		if(((i - home) & mask) >= ((i - hole) & mask)){
+			perHistoryIndex[hole] = perHistoryIndex[i];
+			hole = i;
+		}
+	}
+	perHistoryIndex[hole] = SCPI_ETSI_TEST_PER_HISTORY_EMPTY;
+}
+
+/**
+ *  Stores PER test result in history, replacing older result of the same test ID.
+ *
+ *  @param[in] result - PER test result
+ *  @param[in] decision - PER limit settings the test was run with
+*/
+static void SCPI_ETSI_TEST_AddPERHistory(const SCPI_ETSI_TEST_PERTestResult* result, const SCPI_ETSI_TEST_PERDecision* decision){
+	const uint16_t position = perHistoryHead;
+	if(SCPI_ETSI_TEST_PER_HISTORY_LENGTH == perHistoryCount){
+		SCPI_ETSI_TEST_RemovePERHistoryEntry(position);
+	} else{
+		perHistoryCount++;
+	}
+	perHistory[position] = *result;
+	perHistoryDecisions[position] = *decision;
+	*SCPI_ETSI_TEST_FindPERHistoryEntry(result->testID) = position;
+	perHistoryHead = (uint16_t)((position + 1) & (SCPI_ETSI_TEST_PER_HISTORY_LENGTH - 1));
+}
+
+/**
+ *  Gets PER test result from history.
+ *
+ *  @param[in] testID - identification number of PER test
+ *  @param[out] decision - PER limit settings the test was run with, set when the result is stored
+ *  @return address of the result, NULL when it is not stored
+*/
+static const SCPI_ETSI_TEST_PERTestResult* SCPI_ETSI_TEST_GetPERHistory(uint32_t testID, SCPI_ETSI_TEST_PERDecision* decision){
+	const uint16_t position = *SCPI_ETSI_TEST_FindPERHistoryEntry(testID);
+	if(SCPI_ETSI_TEST_PER_HISTORY_EMPTY != position){
+		*decision = perHistoryDecisions[position];
+		return &perHistory[position];
+	}
+	return NULL;
+}
+
+/**
+ *  Gets history position of n-th stored result, oldest first. Results replaced by a newer
+ *  result of the same test ID are skipped by the caller using SCPI_ETSI_TEST_IsPERHistoryCurrent.
+ *
+ *  @param[in] n - result number, lower than perHistoryCount
+ *  @return perHistory position
+*/
+static uint16_t SCPI_ETSI_TEST_GetPERHistoryPosition(uint16_t n){
+	return (uint16_t)((perHistoryHead - perHistoryCount + n) & (SCPI_ETSI_TEST_PER_HISTORY_LENGTH - 1));
+}
+
+/**
+ *  Checks if result at given history position is the latest result of its test ID.
+ *
+ *  @param[in] position - perHistory position
+ *  @return true when the result is current, false when it was replaced
+*/
+static bool SCPI_ETSI_TEST_IsPERHistoryCurrent(uint16_t position){
+	return *SCPI_ETSI_TEST_FindPERHistoryEntry(perHistory[position].testID) == position;
+}
+
+/**
+ *  Stores results of finished PER tests started by PER command in history.
+*/
+static void SCPI_ETSI_TEST_CollectPERResults(void){
+	for(uint16_t slot=0; (0 != perPendingSlots) && (slot < SCPI_ETSI_TEST_PER_MAX_SLOT_BITS); slot++){
+		const uint32_t mask = (uint32_t)1 << slot;
+		if((0 != (perPendingSlots & mask)) && (false == SCPI_ETSI_TEST_USER_IsPERTestRunning(&deviceDesc, slot))){
+			const SCPI_ETSI_TEST_PERTestResult* result = SCPI_ETSI_TEST_USER_GetPERTestResult(&deviceDesc, slot);
+			if(NULL != result){
+				const SCPI_ETSI_TEST_PERDecision decision = SCPI_ETSI_TEST_GetPERSlotDecision(slot);
+				SCPI_ETSI_TEST_AddPERHistory(result, &decision);
+			}
+			perPendingSlots &= ~mask;
+		}
+	}
+}
+
+/**
+ *  Clears completion notifications of PER test slots.
+ *
+ *  @param[in] mask - PER test slots, bit per slot
+*/
+static void SCPI_ETSI_TEST_ClearPERTestFinished(uint32_t mask){
+#if defined(__ATOMIC_ACQ_REL)
+	__atomic_fetch_and(&perFinishedSlots, ~mask, __ATOMIC_ACQ_REL);
+#else
+	perFinishedSlots &= ~mask;
+#endif
+}
+
+/**
+ *  Gets progress of PER test as values of PER#:PROGress? response: test ID, packets sent,
+ *  packets received, PER in ppm and estimated remaining time in ms.
+ *
+ *  @param[in] slot - PER test slot
+ *  @param[out] values - response values
+ *  @return true on success, false otherwise
+*/
+static bool SCPI_ETSI_TEST_GetPERProgressValues(uint16_t slot, int64_t values[5]){
+	SCPI_ETSI_TEST_PERTestProgress progress;
+	if(SCPI_ETSI_TEST_USER_GetPERTestProgress(&deviceDesc, slot, &progress)){
+		const uint32_t sent = progress.sentPacketsNumber;
+		const uint32_t received = (progress.receivedPacketsNumber < sent) ? progress.receivedPacketsNumber : sent;
+		values[0] = progress.testID;
+		values[1] = sent;
+		values[2] = received;
+		values[3] = (sent > 0) ? (int64_t)(((uint64_t)(sent - received) * SCPI_ETSI_TEST_PPM) / sent) : 0;
+		values[4] = progress.remainingTime;
+		return true;
+	}
+	return false;
+}
+
+/**
+ *  Sends progress reports of running PER tests when the push interval elapses. Every report
+ *  is an ASCII line "PROGress <slot>,<PER#:PROGress? values>", the final one is sent when the
+ *  test finishes.
+*/
+static void SCPI_ETSI_TEST_PushPERProgress(void){
+	const uint32_t now = SCPI_ETSI_TEST_USER_GetTime();
+	if((0 == perPushInterval) || ((uint32_t)(now - perPushTime) < perPushInterval)){
+		return;
+	}
+	perPushTime = now;
+	uint16_t slots = SCPI_ETSI_TEST_GetPERSlot(deviceDesc.phyCount, 0);
+	if(slots > SCPI_ETSI_TEST_PER_MAX_SLOT_BITS){
+		slots = SCPI_ETSI_TEST_PER_MAX_SLOT_BITS;
+	}
+	for(uint16_t slot=0; slot < slots; slot++){
+		const uint32_t mask = (uint32_t)1 << slot;
+		if(SCPI_ETSI_TEST_USER_IsPERTestRunning(&deviceDesc, slot)){
+			perPushSlots |= mask;
+		} else if(0 == (perPushSlots & mask)){
+			continue;
+		} else{
+			perPushSlots &= ~mask;
+		}
+		int64_t values[5];
+		if(SCPI_ETSI_TEST_GetPERProgressValues(slot, values)){
+			char buffer[STRING_BUFF_SIZE];
+			snprintf(buffer, sizeof(buffer), "PROGress %"PRIu16",%"PRId64",%"PRId64",%"PRId64",%"PRId64",%"PRId64"\n",
+					slot, values[0], values[1], values[2], values[3], values[4]);
+			SCPI_ETSI_TEST_Send(buffer, strlen(buffer));
+		}
+	}
+}
+
+/**
+ *  Waits until PER test of given slot finishes. The processor is parked in SCPI_ETSI_TEST_USER_WaitForEvent,
+ *  test status is checked again only when it returns.
+ *
+ *  @param[in] slot - PER test slot
+ *  @param[in] timeout - maximal waiting time in ms
+ *  @return true when PER test is not running, false on timeout
+*/
+static bool SCPI_ETSI_TEST_WaitForPERTest(uint16_t slot, uint32_t timeout){
+	const uint32_t mask = (slot < SCPI_ETSI_TEST_PER_MAX_SLOT_BITS) ? ((uint32_t)1 << slot) : 0;
+	const uint32_t start = SCPI_ETSI_TEST_USER_GetTime();
+	// clear stale notification before checking the status, so a test finishing in between is not missed
+	SCPI_ETSI_TEST_ClearPERTestFinished(mask);
+	while(0 == (perFinishedSlots & mask)){
+		if(false == SCPI_ETSI_TEST_USER_IsPERTestRunning(&deviceDesc, slot)){
+			break;
+		}
+		const uint32_t elapsed = SCPI_ETSI_TEST_USER_GetTime() - start;
+		if(elapsed >= timeout){
+			return false;
+		}
+		SCPI_ETSI_TEST_USER_WaitForEvent(timeout - elapsed);
+	}
+	return true;
+}
+
+/**
+ *  Runs PER test with the current settings and waits until it finishes.
+ *
+ *  @param[in] testID - identification number of PER test
+ *  @param[out] result - PER test result
+ *  @return true on success, false otherwise
+*/
+static bool SCPI_ETSI_TEST_RunPERTest(uint32_t testID, SCPI_ETSI_TEST_PERTestResult* result){
+	const uint16_t slot = SCPI_ETSI_TEST_GetSelectedPERSlot();
+	SCPI_ETSI_TEST_CollectPERResults();
+	if(SCPI_ETSI_TEST_USER_StartPERTest(&deviceDesc, slot, testID)){
+		SCPI_ETSI_TEST_SetPERSlotDecision(slot);
+		SCPI_ETSI_TEST_WaitForPERTest(slot, UINT32_MAX);
+		const SCPI_ETSI_TEST_PERTestResult* testResult = SCPI_ETSI_TEST_USER_GetPERTestResult(&deviceDesc, slot);
+		if(NULL != testResult){
+			*result = *testResult;
+			return true;
+		}
+	}
+	return false;
+}
+
+#if defined(__GNUC__)
+/**
+ *  Default for devices without a sweep implementation, the grid is run one PER test after another.
+ *  Weak, so a user implementation replaces it at link time.
+ *
+ *  @param[inout] deviceDescriptor - pointer to the device descriptor structure
+ *  @param[in] testID - identification number of the PER test of grid point 0
+ *  @param[in] firstPoint - index of the first grid point of the batch
+ *  @param[in] pointCount - number of grid points of the batch
+ *  @param[out] results - PER test results of the batch
+ *  @return false, sweep has not been run
+*/
+__attribute__((weak)) bool SCPI_ETSI_TEST_USER_RunPERSweep(SCPI_ETSI_TEST_DeviceDescriptor* deviceDescriptor, uint32_t testID, size_t firstPoint,
+		size_t pointCount, SCPI_ETSI_TEST_PERTestResult* results){
+	(void)deviceDescriptor;
+	(void)testID;
+	(void)firstPoint;
+	(void)pointCount;
+	(void)results;
+	return false;
+}
+#endif
+
+/**
+ *  Runs batch of PER sweep of the selected PHY one PER test after another, using the PER test user functions.
+ *  Settings are restored afterwards.
+ *
+ *  @param[in] testID - identification number of the PER test of grid point 0
+ *  @param[in] powerCount - number of power levels
+ *  @param[in] firstPoint - index of the first grid point of the batch
+ *  @param[in] pointCount - number of grid points of the batch
+ *  @param[out] results - PER test results of the batch, ordered by channel, then by power
+ *  @return true on success, false otherwise
+*/
+static bool SCPI_ETSI_TEST_RunPERSweep(uint32_t testID, size_t powerCount, size_t firstPoint, size_t pointCount, SCPI_ETSI_TEST_PERTestResult* results){
+	const SCPI_ETSI_TEST_PhySettings settings = deviceDesc.phySettings;
+	const int8_t lowestPower = deviceDesc.phyCapabilities[settings.phyNumber].lowestPower;
+	bool success = true;
+	for(size_t i=0; success && (i < pointCount); i++){
+		const size_t point = firstPoint + i;
+		deviceDesc.phySettings.channelNumber = (uint16_t)(point / powerCount);
+		deviceDesc.phySettings.power = (int8_t)(lowestPower + (int)(point % powerCount));
+		success = SCPI_ETSI_TEST_RunPERTest(testID + (uint32_t)point, &results[i]);
+	}
+	deviceDesc.phySettings = settings;
+	return success;
+}
+
+/**
+ *  Checks if PER test at given power meets the PER limit. The limit is applied as PER limit of
+ *  the test, so backends running sequential PER tests stop as soon as it is decided.
+ *
+ *  @param[in] power - transmit power in dBm
+ *  @param[in] limit - PER limit in ppm
+ *  @param[inout] testID - identification number of PER test, incremented
+ *  @param[inout] packets - number of packets sent, increased by packets of the test
+ *  @param[out] passed - true when PER is not above the limit
+ *  @return true on success, false otherwise
+*/
+static bool SCPI_ETSI_TEST_CheckSensitivity(int8_t power, uint32_t limit, uint32_t* testID, uint64_t* packets, bool* passed){
+	SCPI_ETSI_TEST_PERTestResult result;
+	deviceDesc.phySettings.power = power;
+	deviceDesc.phySettings.perLimit = limit;
+	if(SCPI_ETSI_TEST_RunPERTest((*testID)++, &result) && (result.receivedPacketsNumber <= result.totalPacketsNumber)){
+		const uint64_t errors = result.totalPacketsNumber - result.receivedPacketsNumber;
+		*packets += result.totalPacketsNumber;
+		*passed = (errors * SCPI_ETSI_TEST_PPM <= (uint64_t)limit * result.totalPacketsNumber);
+		return true;
+	}
+	return false;
+}
+
+/**
+ *  Searches the lowest transmit power of the selected PHY at which PER does not exceed the limit.
+ *  PER is assumed to fall with rising power, the power range is bisected. Settings are restored afterwards.
+ *
+ *  @param[in] limit - PER limit in ppm
+ *  @param[in] testID - identification number of the first PER test
+ *  @param[out] power - sensitivity threshold power in dBm
+ *  @param[out] packets - number of packets sent during the search
+ *  @return true when the threshold has been found, false otherwise
+*/
+static bool SCPI_ETSI_TEST_FindSensitivity(uint32_t limit, uint32_t testID, int8_t* power, uint64_t* packets){
+	const SCPI_ETSI_TEST_PhySettings settings = deviceDesc.phySettings;
+	const SCPI_ETSI_TEST_PhyCapabilities* capabilities = &deviceDesc.phyCapabilities[settings.phyNumber];
+	int low = capabilities->lowestPower;
+	int high = capabilities->highestPower;
+	bool passed = false;
+	bool success = (low <= high);
+	*packets = 0;
+	// the highest power has to pass, otherwise there is no threshold in range
+	success = success && SCPI_ETSI_TEST_CheckSensitivity((int8_t)high, limit, &testID, packets, &passed) && passed;
+	if(success && (low < high)){
+		success = SCPI_ETSI_TEST_CheckSensitivity((int8_t)low, limit, &testID, packets, &passed);
+		if(success && passed){
+			high = low;
+		}
+		// low always fails and high always passes
+		while(success && (high - low > 1)){
+			const int middle = low + (high - low) / 2;
+			success = SCPI_ETSI_TEST_CheckSensitivity((int8_t)middle, limit, &testID, packets, &passed);
+			if(passed){
+				high = middle;
+			} else{
+				low = middle;
+			}
+		}
+	}
+	*power = (int8_t)high;
+	deviceDesc.phySettings = settings;
+	return success;
+}
+
+/**
+ *  Sends result of PER test in PERRESULT? format. PER interval and verdict are decided against
+ *  the PER limit settings the test was run with. While the test is running, the interval is
+ *  estimated from packets sent so far and the verdict is not given yet.
+ *
+ *  @param[in] context - parser context
+ *  @param[in] testResult - PER test result or NULL
+ *  @param[in] decision - PER limit settings of the test
+ *  @param[in] progress - progress of the running test, NULL when the test is not running
+ *  @return true on success, false when the result is not available
+*/
+static bool SCPI_ETSI_TEST_SendPERTestResult(scpi_t* context, const SCPI_ETSI_TEST_PERTestResult* testResult,
+		const SCPI_ETSI_TEST_PERDecision* decision, const SCPI_ETSI_TEST_PERTestProgress* progress){
+	if(NULL != testResult){
+		const SCPI_ETSI_TEST_PhySettings settings = { .perLimit = decision->perLimit, .perConfidence = decision->perConfidence };
+		uint32_t sent = testResult->totalPacketsNumber;
+		uint32_t received = testResult->receivedPacketsNumber;
+		uint32_t lower = 0;
+		uint32_t upper = 0;
+		if(NULL != progress){
+			sent = progress->sentPacketsNumber;
+			received = (progress->receivedPacketsNumber < sent) ? progress->receivedPacketsNumber : sent;
+		}
+		SCPI_ETSI_TEST_PERVerdict verdict = SCPI_ETSI_TEST_GetPERVerdict(&settings, sent, received, &lower, &upper);
+		if(NULL != progress){
+			verdict = SCPI_ETSI_TEST_PER_UNDECIDED;
+		}
+		const int64_t result[] = { testResult->testID, testResult->totalPacketsNumber, testResult->receivedPacketsNumber, lower, upper, verdict };
+		// PER interval and verdict are appended only when PER limit is set
+		const size_t count = (0 != decision->perLimit) ? 6 : 3;
+		SCPI_ETSI_TEST_SendNumbers(context, result, count);
+		return true;
+	}
+	return false;
+}
+
+void SCPI_ETSI_TEST_PERTestFinished(uint16_t slot){
+	if(slot < SCPI_ETSI_TEST_PER_MAX_SLOT_BITS){
+#if defined(__ATOMIC_ACQ_REL)
+		__atomic_fetch_or(&perFinishedSlots, (uint32_t)1 << slot, __ATOMIC_ACQ_REL);
+#else
+		perFinishedSlots |= (uint32_t)1 << slot;
+#endif
+	}
+}
 
 SCPIResult SCPI_ETSI_TEST_Init(void){
 	if(NULL != scpiInputBuffer){
@@ -142,8 +1014,26 @@ SCPIResult SCPI_ETSI_TEST_Init(void){
 			// initialize parser library
 			SCPI_Init(&scpiContext, scpiCommands, &scpiInterface, scpi_units_def, NULL, NULL, NULL, NULL, scpiInputBuffer,
 					SCPI_INPUT_BUFFER_LENGTH, scpiErrorBuffer, SCPI_ERROR_QUEUE_SIZE);
+#if USE_CHOICE_INDEX
+			// lists not registered (no free slot) are still searched linearly
+			if(SCPI_ChoiceIndexInit(&frequencyMatchPoliciesIndex, frequencyMatchPolicies)){
+				SCPI_ChoiceIndexRegister(&scpiContext, &frequencyMatchPoliciesIndex);
+			}
+			if(SCPI_ChoiceIndexInit(&dataFormatsIndex, dataFormats)){
+				SCPI_ChoiceIndexRegister(&scpiContext, &dataFormatsIndex);
+			}
+			if(SCPI_ChoiceIndexInit(&byteOrdersIndex, byteOrders)){
+				SCPI_ChoiceIndexRegister(&scpiContext, &byteOrdersIndex);
+			}
+#endif
+			SCPI_ETSI_TEST_ClearPERHistory();
+			// PER statistics defaults, the user implementation may override them
+			deviceDesc.phySettings.perSeed = SCPI_ETSI_TEST_DEFAULT_PER_SEED;
+			deviceDesc.phySettings.perLimit = SCPI_ETSI_TEST_DEFAULT_PER_LIMIT;
+			deviceDesc.phySettings.perConfidence = SCPI_ETSI_TEST_DEFAULT_PER_CONFIDENCE;
 			// initialize user implementation (filling up data structures)
 			SCPI_ETSI_TEST_USER_Init(&deviceDesc);
+			SCPI_ETSI_TEST_BuildChannelIndex(deviceDesc.phySettings.phyNumber);
 			return SCPI_OK;
 		}
 	}
@@ -153,6 +1043,9 @@ SCPIResult SCPI_ETSI_TEST_Init(void){
 SCPIResult SCPI_ETSI_TEST_Proc(void){
 	SCPIResult result = SCPI_ERROR;
 	uint8_t byte = 0;
+	// progress reports are sent between commands only, never inside a response
+	SCPI_ETSI_TEST_PushPERProgress();
+	SCPI_ETSI_TEST_CollectPERResults();
 	if(NULL != commandBuffer){
 		// try to get character from input at least once
 		do{
@@ -201,6 +1094,14 @@ scpi_result_t SCPI_ETSI_TEST_GetIDN(scpi_t* context){
 scpi_result_t SCPI_ETSI_TEST_Reset(scpi_t* context){
 	if(NULL != context) {
 		SCPI_ETSI_TEST_Send("OK\n", 3);
+		dataFormat = DATA_FORMAT_ASCII;
+		byteOrder = SCPI_FORMAT_NORMAL;
+		deviceDesc.phySettings.perSeed = SCPI_ETSI_TEST_DEFAULT_PER_SEED;
+		deviceDesc.phySettings.perLimit = SCPI_ETSI_TEST_DEFAULT_PER_LIMIT;
+		deviceDesc.phySettings.perConfidence = SCPI_ETSI_TEST_DEFAULT_PER_CONFIDENCE;
+		perPushInterval = 0;
+		perPushSlots = 0;
+		perPendingSlots = 0;
 		SCPI_ETSI_TEST_USER_Reset(&deviceDesc);
 		return SCPI_RES_OK;
 	}
@@ -210,10 +1111,8 @@ scpi_result_t SCPI_ETSI_TEST_Reset(scpi_t* context){
 
 scpi_result_t SCPI_ETSI_TEST_GetPhyCount(scpi_t* context){
 	if(NULL != context) {
-		char buffer[UINT8_BUFF_SIZE];
 		const uint8_t phyCount = deviceDesc.phyCount;
-		snprintf(buffer, sizeof(buffer), "%u\n", phyCount);
-		SCPI_ETSI_TEST_Send(buffer, strlen(buffer));
+		SCPI_ETSI_TEST_SendNumber(context, phyCount);
 		return SCPI_RES_OK;
 	}
 	SCPI_ETSI_TEST_Send("ERR\n", 4);
@@ -222,18 +1121,17 @@ scpi_result_t SCPI_ETSI_TEST_GetPhyCount(scpi_t* context){
 
 scpi_result_t SCPI_ETSI_TEST_GetPhyCapabilities(scpi_t* context){
 	if(NULL != context) {
-		char buffer[STRING_BUFF_SIZE];
 		int32_t phy;
 		// get phy suffix from command
 		SCPI_CommandNumbers(context, &phy, 1, 0);
 		// check if phy value is not out of bounds
 		if(phy <= deviceDesc.phyCount-1){
-			snprintf(buffer, sizeof(buffer), "%"PRIu32",%"PRIu32",%"PRIu16",%"PRIu32",%"PRIu32",%i,%i,%i,%"PRIu16",%"PRIu16",%"PRIu16",%u,%u,%u\n", deviceDesc.phyCapabilities[phy].lowestFrequency,
+			const int64_t capabilities[] = { deviceDesc.phyCapabilities[phy].lowestFrequency,
 					deviceDesc.phyCapabilities[phy].highestFrequency, deviceDesc.phyCapabilities[phy].channelCount, deviceDesc.phyCapabilities[phy].channelBandwidth, deviceDesc.phyCapabilities[phy].baudrate,
 					deviceDesc.phyCapabilities[phy].lowestPower, deviceDesc.phyCapabilities[phy].highestPower, deviceDesc.phyCapabilities[phy].defaultPower, deviceDesc.phyCapabilities[phy].minimalPacketLength,
 					deviceDesc.phyCapabilities[phy].maximalPacketLength, deviceDesc.phyCapabilities[phy].defaultPERPacketLength, deviceDesc.phyCapabilities[phy].modulationType, deviceDesc.phyCapabilities[phy].supportedSignals,
-					deviceDesc.phyCapabilities[phy].antennaCount);
-			SCPI_ETSI_TEST_Send(buffer, strlen(buffer));
+					deviceDesc.phyCapabilities[phy].antennaCount };
+			SCPI_ETSI_TEST_SendNumbers(context, capabilities, sizeof(capabilities)/sizeof(capabilities[0]));
 			return SCPI_RES_OK;
 		}
 	}
@@ -243,15 +1141,13 @@ scpi_result_t SCPI_ETSI_TEST_GetPhyCapabilities(scpi_t* context){
 
 scpi_result_t SCPI_ETSI_TEST_GetLowestFrequency(scpi_t* context){
 	if(NULL != context) {
-		char buffer[UINT32_BUFF_SIZE];
 		int32_t phy;
 		// get phy suffix from command
 		SCPI_CommandNumbers(context, &phy, 1, 0);
 		// check if phy value is not out of bounds
 		if(phy <= deviceDesc.phyCount-1){
 			const uint32_t freq = deviceDesc.phyCapabilities[phy].lowestFrequency;
-			snprintf(buffer, sizeof(buffer), "%"PRIu32"\n", freq);
-			SCPI_ETSI_TEST_Send(buffer, strlen(buffer));
+			SCPI_ETSI_TEST_SendNumber(context, freq);
 			return SCPI_RES_OK;
 		}
 	}
@@ -261,15 +1157,13 @@ scpi_result_t SCPI_ETSI_TEST_GetLowestFrequency(scpi_t* context){
 
 scpi_result_t SCPI_ETSI_TEST_GetHighestFrequency(scpi_t* context){
 	if(NULL != context) {
-		char buffer[UINT32_BUFF_SIZE];
 		int32_t phy;
 		// get phy suffix from command
 		SCPI_CommandNumbers(context, &phy, 1, 0);
 		// check if phy value is not out of bounds
 		if(phy <= deviceDesc.phyCount-1){
 			const uint32_t freq = deviceDesc.phyCapabilities[phy].highestFrequency;
-			snprintf(buffer, sizeof(buffer), "%"PRIu32"\n", freq);
-			SCPI_ETSI_TEST_Send(buffer, strlen(buffer));
+			SCPI_ETSI_TEST_SendNumber(context, freq);
 			return SCPI_RES_OK;
 		}
 	}
@@ -279,15 +1173,13 @@ scpi_result_t SCPI_ETSI_TEST_GetHighestFrequency(scpi_t* context){
 
 scpi_result_t SCPI_ETSI_TEST_GetChannelCount(scpi_t* context){
 	if(NULL != context) {
-		char buffer[UINT16_BUFF_SIZE];
 		int32_t phy;
 		// get phy suffix from command
 		SCPI_CommandNumbers(context, &phy, 1, 0);
 		// check if phy value is not out of bounds
 		if(phy <= deviceDesc.phyCount-1){
 			const uint16_t channelCount = deviceDesc.phyCapabilities[phy].channelCount;
-			snprintf(buffer, sizeof(buffer), "%"PRIu16"\n", channelCount);
-			SCPI_ETSI_TEST_Send(buffer, strlen(buffer));
+			SCPI_ETSI_TEST_SendNumber(context, channelCount);
 			return SCPI_RES_OK;
 		}
 	}
@@ -297,15 +1189,13 @@ scpi_result_t SCPI_ETSI_TEST_GetChannelCount(scpi_t* context){
 
 scpi_result_t SCPI_ETSI_TEST_GetChannelBandwidth(scpi_t* context){
 	if(NULL != context) {
-		char buffer[UINT32_BUFF_SIZE];
 		int32_t phy;
 		// get phy suffix from command
 		SCPI_CommandNumbers(context, &phy, 1, 0);
 		// check if phy value is not out of bounds
 		if(phy <= deviceDesc.phyCount-1){
 			const uint32_t channelBandwidth = deviceDesc.phyCapabilities[phy].channelBandwidth;
-			snprintf(buffer, sizeof(buffer), "%"PRIu32"\n", channelBandwidth);
-			SCPI_ETSI_TEST_Send(buffer, strlen(buffer));
+			SCPI_ETSI_TEST_SendNumber(context, channelBandwidth);
 			return SCPI_RES_OK;
 		}
 	}
@@ -315,15 +1205,13 @@ scpi_result_t SCPI_ETSI_TEST_GetChannelBandwidth(scpi_t* context){
 
 scpi_result_t SCPI_ETSI_TEST_GetBaudrate(scpi_t* context){
 	if(NULL != context) {
-		char buffer[UINT32_BUFF_SIZE];
 		int32_t phy;
 		// get phy suffix from command
 		SCPI_CommandNumbers(context, &phy, 1, 0);
 		// check if phy value is not out of bounds
 		if(phy <= deviceDesc.phyCount-1){
 			const uint32_t baudrate = deviceDesc.phyCapabilities[phy].baudrate;
-			snprintf(buffer, sizeof(buffer), "%"PRIu32"\n", baudrate);
-			SCPI_ETSI_TEST_Send(buffer, strlen(buffer));
+			SCPI_ETSI_TEST_SendNumber(context, baudrate);
 			return SCPI_RES_OK;
 		}
 	}
@@ -333,15 +1221,13 @@ scpi_result_t SCPI_ETSI_TEST_GetBaudrate(scpi_t* context){
 
 scpi_result_t SCPI_ETSI_TEST_GetLowestPower(scpi_t* context){
 	if(NULL != context) {
-		char buffer[INT8_BUFF_SIZE];
 		int32_t phy;
 		// get phy suffix from command
 		SCPI_CommandNumbers(context, &phy, 1, 0);
 		// check if phy value is not out of bounds
 		if(phy <= deviceDesc.phyCount-1){
 			const int8_t power = deviceDesc.phyCapabilities[phy].lowestPower;
-			snprintf(buffer, sizeof(buffer), "%i\n", power);
-			SCPI_ETSI_TEST_Send(buffer, strlen(buffer));
+			SCPI_ETSI_TEST_SendNumber(context, power);
 			return SCPI_RES_OK;
 		}
 	}
@@ -351,15 +1237,13 @@ scpi_result_t SCPI_ETSI_TEST_GetLowestPower(scpi_t* context){
 
 scpi_result_t SCPI_ETSI_TEST_GetHighestPower(scpi_t* context){
 	if(NULL != context) {
-		char buffer[INT8_BUFF_SIZE];
 		int32_t phy;
 		// get phy suffix from command
 		SCPI_CommandNumbers(context, &phy, 1, 0);
 		// check if phy value is not out of bounds
 		if(phy <= deviceDesc.phyCount-1){
 			const int8_t power = deviceDesc.phyCapabilities[phy].highestPower;
-			snprintf(buffer, sizeof(buffer), "%i\n", power);
-			SCPI_ETSI_TEST_Send(buffer, strlen(buffer));
+			SCPI_ETSI_TEST_SendNumber(context, power);
 			return SCPI_RES_OK;
 		}
 	}
@@ -369,15 +1253,13 @@ scpi_result_t SCPI_ETSI_TEST_GetHighestPower(scpi_t* context){
 
 scpi_result_t SCPI_ETSI_TEST_GetMinPacketLength(scpi_t* context){
 	if(NULL != context) {
-		char buffer[UINT16_BUFF_SIZE];
 		int32_t phy;
 		// get phy suffix from command
 		SCPI_CommandNumbers(context, &phy, 1, 0);
 		// check if phy value is not out of bounds
 		if(phy <= deviceDesc.phyCount-1){
 			const uint16_t pktLen = deviceDesc.phyCapabilities[phy].minimalPacketLength;
-			snprintf(buffer, sizeof(buffer), "%"PRIu16"\n", pktLen);
-			SCPI_ETSI_TEST_Send(buffer, strlen(buffer));
+			SCPI_ETSI_TEST_SendNumber(context, pktLen);
 			return SCPI_RES_OK;
 		}
 	}
@@ -387,15 +1269,13 @@ scpi_result_t SCPI_ETSI_TEST_GetMinPacketLength(scpi_t* context){
 
 scpi_result_t SCPI_ETSI_TEST_GetMaxPacketLength(scpi_t* context){
 	if(NULL != context) {
-		char buffer[UINT16_BUFF_SIZE];
 		int32_t phy;
 		// get phy suffix from command
 		SCPI_CommandNumbers(context, &phy, 1, 0);
 		// check if phy value is not out of bounds
 		if(phy <= deviceDesc.phyCount-1){
 			const uint16_t pktLen = deviceDesc.phyCapabilities[phy].maximalPacketLength;
-			snprintf(buffer, sizeof(buffer), "%"PRIu16"\n", pktLen);
-			SCPI_ETSI_TEST_Send(buffer, strlen(buffer));
+			SCPI_ETSI_TEST_SendNumber(context, pktLen);
 			return SCPI_RES_OK;
 		}
 	}
@@ -405,15 +1285,13 @@ scpi_result_t SCPI_ETSI_TEST_GetMaxPacketLength(scpi_t* context){
 
 scpi_result_t SCPI_ETSI_TEST_GetModulationType(scpi_t* context){
 	if(NULL != context) {
-		char buffer[UINT8_BUFF_SIZE];
 		int32_t phy;
 		// get phy suffix from command
 		SCPI_CommandNumbers(context, &phy, 1, 0);
 		// check if phy value is not out of bounds
 		if(phy <= deviceDesc.phyCount-1){
 			const uint8_t mod = deviceDesc.phyCapabilities[phy].modulationType;
-			snprintf(buffer, sizeof(buffer), "%u\n", mod);
-			SCPI_ETSI_TEST_Send(buffer, strlen(buffer));
+			SCPI_ETSI_TEST_SendNumber(context, mod);
 			return SCPI_RES_OK;
 		}
 	}
@@ -423,15 +1301,13 @@ scpi_result_t SCPI_ETSI_TEST_GetModulationType(scpi_t* context){
 
 scpi_result_t SCPI_ETSI_TEST_GetSupportedSignals(scpi_t* context){
 	if(NULL != context) {
-		char buffer[UINT8_BUFF_SIZE];
 		int32_t phy;
 		// get phy suffix from command
 		SCPI_CommandNumbers(context, &phy, 1, 0);
 		// check if phy value is not out of bounds
 		if(phy <= deviceDesc.phyCount-1){
 			const uint8_t signals = deviceDesc.phyCapabilities[phy].supportedSignals;
-			snprintf(buffer, sizeof(buffer), "%u\n", signals);
-			SCPI_ETSI_TEST_Send(buffer, strlen(buffer));
+			SCPI_ETSI_TEST_SendNumber(context, signals);
 			return SCPI_RES_OK;
 		}
 	}
@@ -441,15 +1317,13 @@ scpi_result_t SCPI_ETSI_TEST_GetSupportedSignals(scpi_t* context){
 
 scpi_result_t SCPI_ETSI_TEST_GetAntennaCount(scpi_t* context){
 	if(NULL != context) {
-		char buffer[UINT8_BUFF_SIZE];
 		int32_t phy;
 		// get phy suffix from command
 		SCPI_CommandNumbers(context, &phy, 1, 0);
 		// check if phy value is not out of bounds
 		if(phy <= deviceDesc.phyCount-1){
 			const uint8_t antennaCount = deviceDesc.phyCapabilities[phy].antennaCount;
-			snprintf(buffer, sizeof(buffer), "%u\n", antennaCount);
-			SCPI_ETSI_TEST_Send(buffer, strlen(buffer));
+			SCPI_ETSI_TEST_SendNumber(context, antennaCount);
 			return SCPI_RES_OK;
 		}
 	}
@@ -484,8 +1358,24 @@ scpi_result_t SCPI_ETSI_TEST_GetChannelList(scpi_t* context){
 		// get phy suffix from command
 		SCPI_CommandNumbers(context, &phy, 1, 0);
 		// check if phy value is not out of bounds
-		if(phy <= deviceDesc.phyCount-1){
-			const uint32_t* channelList = *deviceDesc.phyChannelList;
+		if((phy >= 0) && (phy <= deviceDesc.phyCount-1) && (NULL != deviceDesc.phyChannelList)){
+			// channel list of the phy given by command suffix
+			const uint32_t* channelList = deviceDesc.phyChannelList[phy];
+			if((NULL != channelList) && (DATA_FORMAT_ASCII != dataFormat)){
+				// send channel number and frequency pairs as one block, packed in chunks
+				const size_t channelCount = deviceDesc.phyCapabilities[phy].channelCount;
+				int64_t pairs[SCPI_ETSI_TEST_BLOCK_CHUNK];
+				SCPI_ETSI_TEST_SendBlockHeader(context, 2 * channelCount);
+				for(size_t channel=0; channel < channelCount; channel += SCPI_ETSI_TEST_BLOCK_CHUNK/2){
+					size_t count = 0;
+					for(size_t i=channel; (i < channelCount) && (count < SCPI_ETSI_TEST_BLOCK_CHUNK); i++){
+						pairs[count++] = (int64_t)i;
+						pairs[count++] = channelList[i];
+					}
+					SCPI_ETSI_TEST_SendBlockValues(context, pairs, count);
+				}
+				return SCPI_RES_OK;
+			}
 			if(NULL != channelList){
 				// print about all channel list
 				for(int channel=0; channel < deviceDesc.phyCapabilities[phy].channelCount; channel++){
@@ -507,7 +1397,6 @@ scpi_result_t SCPI_ETSI_TEST_GetChannelList(scpi_t* context){
 
 scpi_result_t SCPI_ETSI_TEST_GetChannel(scpi_t* context){
 	if(NULL != context) {
-		char buffer[UINT32_BUFF_SIZE];
 		int32_t params[2];
 		// get phy suffix and channel suffix from command
 		SCPI_CommandNumbers(context, params, 2, 0);
@@ -520,8 +1409,7 @@ scpi_result_t SCPI_ETSI_TEST_GetChannel(scpi_t* context){
 				// check if channel number is not out of bounds
 				if(channelNumber <= deviceDesc.phyCapabilities[phy].channelCount - 1){
 					const uint32_t channelFreq = channelList[channelNumber];
-					snprintf(buffer, sizeof(buffer), "%"PRIu32"\n", channelFreq);
-					SCPI_ETSI_TEST_Send(buffer, strlen(buffer));
+					SCPI_ETSI_TEST_SendNumber(context, channelFreq);
 					return SCPI_RES_OK;
 				}
 			}
@@ -533,11 +1421,10 @@ scpi_result_t SCPI_ETSI_TEST_GetChannel(scpi_t* context){
 
 scpi_result_t SCPI_ETSI_TEST_GetSettings(scpi_t* context){
 	if(NULL != context) {
-		char buffer[STRING_BUFF_SIZE];
-		snprintf(buffer, sizeof(buffer), "%u,%"PRIu16",%u,%i,%u,%"PRIu16",%"PRIu16"\n", deviceDesc.phySettings.phyNumber, deviceDesc.phySettings.channelNumber,
+		const int64_t settings[] = { deviceDesc.phySettings.phyNumber, deviceDesc.phySettings.channelNumber,
 				deviceDesc.phySettings.signalType, deviceDesc.phySettings.power, deviceDesc.phySettings.antennaNumber, deviceDesc.phySettings.perTotalPacketsNumber,
-				deviceDesc.phySettings.perPacketLength);
-		SCPI_ETSI_TEST_Send(buffer, strlen(buffer));
+				deviceDesc.phySettings.perPacketLength };
+		SCPI_ETSI_TEST_SendNumbers(context, settings, sizeof(settings)/sizeof(settings[0]));
 		return SCPI_RES_OK;
 	}
 	SCPI_ETSI_TEST_Send("ERR\n", 4);
@@ -574,6 +1461,10 @@ scpi_result_t SCPI_ETSI_TEST_SetPhy(scpi_t* context){
 								&& (deviceDesc.phyCapabilities[phy].defaultPERPacketLength >= deviceDesc.phyCapabilities[phy].minimalPacketLength)){
 					deviceDesc.phySettings.perPacketLength = deviceDesc.phyCapabilities[phy].defaultPERPacketLength;
 				}
+				deviceDesc.phySettings.perSeed = SCPI_ETSI_TEST_DEFAULT_PER_SEED;
+				deviceDesc.phySettings.perLimit = SCPI_ETSI_TEST_DEFAULT_PER_LIMIT;
+				deviceDesc.phySettings.perConfidence = SCPI_ETSI_TEST_DEFAULT_PER_CONFIDENCE;
+				SCPI_ETSI_TEST_BuildChannelIndex((uint8_t)phy);
 				SCPI_ETSI_TEST_Send("OK\n", 3);
 				return SCPI_RES_OK;
 			}
@@ -585,10 +1476,8 @@ scpi_result_t SCPI_ETSI_TEST_SetPhy(scpi_t* context){
 
 scpi_result_t SCPI_ETSI_TEST_GetSelectedPhy(scpi_t* context){
 	if(NULL != context) {
-		char buffer[UINT8_BUFF_SIZE];
 		const uint8_t phy = deviceDesc.phySettings.phyNumber;
-		snprintf(buffer, sizeof(buffer), "%u\n", phy);
-		SCPI_ETSI_TEST_Send(buffer, strlen(buffer));
+		SCPI_ETSI_TEST_SendNumber(context, phy);
 		return SCPI_RES_OK;
 	}
 	SCPI_ETSI_TEST_Send("ERR\n", 4);
@@ -620,16 +1509,62 @@ scpi_result_t SCPI_ETSI_TEST_SetChannel(scpi_t* context){
 
 scpi_result_t SCPI_ETSI_TEST_GetSelectedChannel(scpi_t* context){
 	if(NULL != context) {
-		char buffer[UINT16_BUFF_SIZE];
 		const uint16_t channel = deviceDesc.phySettings.channelNumber;
-		snprintf(buffer, sizeof(buffer), "%"PRIu16"\n", channel);
-		SCPI_ETSI_TEST_Send(buffer, strlen(buffer));
+		SCPI_ETSI_TEST_SendNumber(context, channel);
 		return SCPI_RES_OK;
 	}
 	SCPI_ETSI_TEST_Send("ERR\n", 4);
 	return SCPI_RES_ERR;
 }
 
+scpi_result_t SCPI_ETSI_TEST_SetFrequency(scpi_t* context){
+	if(NULL != context) {
+		scpi_number_scaled_t frequency;
+		int32_t policy = FREQUENCY_MATCH_EXACT;
+		uint16_t channel;
+		// get frequency in Hz (with optional Hz, kHz, MHz or GHz suffix) from parser, decimal suffixes are applied exactly
+		if(SCPI_ParamNumberInt64Scaled(context, scpi_special_numbers_def, &frequency, 0, TRUE)){
+			// optional match policy, exact match is required by default
+			if(SCPI_ParamChoice(context, frequencyMatchPolicies, &policy, FALSE) || !SCPI_ParamErrorOccurred(context)){
+				if(frequency.special){
+					// MINimum and MAXimum select channel with the lowest and the highest frequency
+					if((channelIndexCount > 0) && (SCPI_NUM_MIN == frequency.content.tag || SCPI_NUM_MAX == frequency.content.tag)){
+						deviceDesc.phySettings.channelNumber = channelIndex[(SCPI_NUM_MIN == frequency.content.tag) ? 0 : (channelIndexCount - 1)];
+						SCPI_ETSI_TEST_Send("OK\n", 3);
+						return SCPI_RES_OK;
+					}
+				} else if((SCPI_UNIT_NONE == frequency.unit || SCPI_UNIT_HERTZ == frequency.unit)
+						&& (frequency.content.value >= 0) && (frequency.content.value <= UINT32_MAX)){
+					if(SCPI_ETSI_TEST_FindChannelByFrequency((uint32_t)frequency.content.value, policy, &channel)){
+						deviceDesc.phySettings.channelNumber = channel;
+						SCPI_ETSI_TEST_Send("OK\n", 3);
+						return SCPI_RES_OK;
+					}
+				}
+			}
+		}
+	}
+	SCPI_ETSI_TEST_Send("ERR\n", 4);
+	return SCPI_RES_ERR;
+}
+
+scpi_result_t SCPI_ETSI_TEST_GetSelectedFrequency(scpi_t* context){
+	if(NULL != context) {
+		const uint8_t phy = deviceDesc.phySettings.phyNumber;
+		const uint16_t channel = deviceDesc.phySettings.channelNumber;
+		// check if phy and channel values are not out of bounds
+		if((phy <= deviceDesc.phyCount-1) && (NULL != deviceDesc.phyChannelList[phy])){
+			if(channel <= deviceDesc.phyCapabilities[phy].channelCount - 1){
+				const uint32_t channelFreq = deviceDesc.phyChannelList[phy][channel];
+				SCPI_ETSI_TEST_SendNumber(context, channelFreq);
+				return SCPI_RES_OK;
+			}
+		}
+	}
+	SCPI_ETSI_TEST_Send("ERR\n", 4);
+	return SCPI_RES_ERR;
+}
+
 scpi_result_t SCPI_ETSI_TEST_SetSignal(scpi_t* context){
 	if(NULL != context) {
 		uint32_t signal;
@@ -655,10 +1590,8 @@ scpi_result_t SCPI_ETSI_TEST_SetSignal(scpi_t* context){
 
 scpi_result_t SCPI_ETSI_TEST_GetSelectedSignal(scpi_t* context){
 	if(NULL != context) {
-		char buffer[UINT8_BUFF_SIZE];
 		const uint8_t signal = deviceDesc.phySettings.signalType;
-		snprintf(buffer, sizeof(buffer), "%u\n", signal);
-		SCPI_ETSI_TEST_Send(buffer, strlen(buffer));
+		SCPI_ETSI_TEST_SendNumber(context, signal);
 		return SCPI_RES_OK;
 	}
 	SCPI_ETSI_TEST_Send("ERR\n", 4);
@@ -691,10 +1624,8 @@ scpi_result_t SCPI_ETSI_TEST_SetPower(scpi_t* context){
 
 scpi_result_t SCPI_ETSI_TEST_GetSelectedPower(scpi_t* context){
 	if(NULL != context) {
-		char buffer[INT8_BUFF_SIZE];
 		const int8_t power = deviceDesc.phySettings.power;
-		snprintf(buffer, sizeof(buffer), "%d\n", power);
-		SCPI_ETSI_TEST_Send(buffer, strlen(buffer));
+		SCPI_ETSI_TEST_SendNumber(context, power);
 		return SCPI_RES_OK;
 	}
 	SCPI_ETSI_TEST_Send("ERR\n", 4);
@@ -726,10 +1657,8 @@ scpi_result_t SCPI_ETSI_TEST_SetAntenna(scpi_t* context){
 
 scpi_result_t SCPI_ETSI_TEST_GetSelectedAntenna(scpi_t* context){
 	if(NULL != context) {
-		char buffer[UINT8_BUFF_SIZE];
 		const uint8_t antenna = deviceDesc.phySettings.antennaNumber;
-		snprintf(buffer, sizeof(buffer), "%u\n", antenna);
-		SCPI_ETSI_TEST_Send(buffer, strlen(buffer));
+		SCPI_ETSI_TEST_SendNumber(context, antenna);
 		return SCPI_RES_OK;
 	}
 	SCPI_ETSI_TEST_Send("ERR\n", 4);
@@ -741,7 +1670,7 @@ scpi_result_t SCPI_ETSI_TEST_SetPERTotalPackets(scpi_t* context){
 		uint32_t packets;
 		// if user put a value into command use it, otherwise use default
 		if(SCPI_ParamUInt32(context, &packets, TRUE)){
-			deviceDesc.phySettings.perTotalPacketsNumber = (uint16_t)packets;
+			deviceDesc.phySettings.perTotalPacketsNumber = packets;
 			SCPI_ETSI_TEST_Send("OK\n", 3);
 			return SCPI_RES_OK;
 		} else{
@@ -756,10 +1685,8 @@ scpi_result_t SCPI_ETSI_TEST_SetPERTotalPackets(scpi_t* context){
 
 scpi_result_t SCPI_ETSI_TEST_GetSelectedPERTotalPackets(scpi_t* context){
 	if(NULL != context) {
-		char buffer[UINT16_BUFF_SIZE];
-		const uint16_t packets = deviceDesc.phySettings.perTotalPacketsNumber;
-		snprintf(buffer, sizeof(buffer), "%"PRIu16"\n", packets);
-		SCPI_ETSI_TEST_Send(buffer, strlen(buffer));
+		const uint32_t packets = deviceDesc.phySettings.perTotalPacketsNumber;
+		SCPI_ETSI_TEST_SendNumber(context, packets);
 		return SCPI_RES_OK;
 	}
 	SCPI_ETSI_TEST_Send("ERR\n", 4);
@@ -792,10 +1719,98 @@ scpi_result_t SCPI_ETSI_TEST_SetPERPacketLength(scpi_t* context){
 
 scpi_result_t SCPI_ETSI_TEST_GetSelectedPERPacketLength(scpi_t* context){
 	if(NULL != context) {
-		char buffer[UINT16_BUFF_SIZE];
 		const uint16_t packetLen = deviceDesc.phySettings.perPacketLength;
-		snprintf(buffer, sizeof(buffer), "%"PRIu16"\n", packetLen);
-		SCPI_ETSI_TEST_Send(buffer, strlen(buffer));
+		SCPI_ETSI_TEST_SendNumber(context, packetLen);
+		return SCPI_RES_OK;
+	}
+	SCPI_ETSI_TEST_Send("ERR\n", 4);
+	return SCPI_RES_ERR;
+}
+
+scpi_result_t SCPI_ETSI_TEST_SetPERSeed(scpi_t* context){
+	if(NULL != context) {
+		uint32_t seed;
+		// if user put a value into command use it, otherwise use default
+		if(SCPI_ParamUInt32(context, &seed, FALSE)){
+			deviceDesc.phySettings.perSeed = seed;
+		} else if(SCPI_ParamErrorOccurred(context)){
+			SCPI_ETSI_TEST_Send("ERR\n", 4);
+			return SCPI_RES_ERR;
+		} else{
+			deviceDesc.phySettings.perSeed = SCPI_ETSI_TEST_DEFAULT_PER_SEED;
+		}
+		SCPI_ETSI_TEST_Send("OK\n", 3);
+		return SCPI_RES_OK;
+	}
+	SCPI_ETSI_TEST_Send("ERR\n", 4);
+	return SCPI_RES_ERR;
+}
+
+scpi_result_t SCPI_ETSI_TEST_GetSelectedPERSeed(scpi_t* context){
+	if(NULL != context) {
+		const uint32_t seed = deviceDesc.phySettings.perSeed;
+		SCPI_ETSI_TEST_SendNumber(context, seed);
+		return SCPI_RES_OK;
+	}
+	SCPI_ETSI_TEST_Send("ERR\n", 4);
+	return SCPI_RES_ERR;
+}
+
+scpi_result_t SCPI_ETSI_TEST_SetPERLimit(scpi_t* context){
+	if(NULL != context) {
+		uint32_t limit;
+		// if user put a value into command use it, otherwise use default
+		if(SCPI_ParamUInt32(context, &limit, FALSE)){
+			if(limit <= SCPI_ETSI_TEST_PPM){
+				deviceDesc.phySettings.perLimit = limit;
+				SCPI_ETSI_TEST_Send("OK\n", 3);
+				return SCPI_RES_OK;
+			}
+		} else if(!SCPI_ParamErrorOccurred(context)){
+			deviceDesc.phySettings.perLimit = SCPI_ETSI_TEST_DEFAULT_PER_LIMIT;
+			SCPI_ETSI_TEST_Send("OK\n", 3);
+			return SCPI_RES_OK;
+		}
+	}
+	SCPI_ETSI_TEST_Send("ERR\n", 4);
+	return SCPI_RES_ERR;
+}
+
+scpi_result_t SCPI_ETSI_TEST_GetSelectedPERLimit(scpi_t* context){
+	if(NULL != context) {
+		const uint32_t limit = deviceDesc.phySettings.perLimit;
+		SCPI_ETSI_TEST_SendNumber(context, limit);
+		return SCPI_RES_OK;
+	}
+	SCPI_ETSI_TEST_Send("ERR\n", 4);
+	return SCPI_RES_ERR;
+}
+
+scpi_result_t SCPI_ETSI_TEST_SetPERConfidence(scpi_t* context){
+	if(NULL != context) {
+		uint32_t confidence;
+		// if user put a value into command use it, otherwise use default
+		if(SCPI_ParamUInt32(context, &confidence, FALSE)){
+			// confidence level must be inside (0, 1)
+			if((confidence > 0) && (confidence < SCPI_ETSI_TEST_PPM)){
+				deviceDesc.phySettings.perConfidence = confidence;
+				SCPI_ETSI_TEST_Send("OK\n", 3);
+				return SCPI_RES_OK;
+			}
+		} else if(!SCPI_ParamErrorOccurred(context)){
+			deviceDesc.phySettings.perConfidence = SCPI_ETSI_TEST_DEFAULT_PER_CONFIDENCE;
+			SCPI_ETSI_TEST_Send("OK\n", 3);
+			return SCPI_RES_OK;
+		}
+	}
+	SCPI_ETSI_TEST_Send("ERR\n", 4);
+	return SCPI_RES_ERR;
+}
+
+scpi_result_t SCPI_ETSI_TEST_GetSelectedPERConfidence(scpi_t* context){
+	if(NULL != context) {
+		const uint32_t confidence = deviceDesc.phySettings.perConfidence;
+		SCPI_ETSI_TEST_SendNumber(context, confidence);
 		return SCPI_RES_OK;
 	}
 	SCPI_ETSI_TEST_Send("ERR\n", 4);
@@ -828,10 +1843,17 @@ scpi_result_t SCPI_ETSI_TEST_StartPERTest(scpi_t* context){
 		uint32_t testID;
 		// get test ID from parser
 		if(SCPI_ParamUInt32(context, &testID, TRUE)){
-			// check if any test is running at the moment
-			if(false == SCPI_ETSI_TEST_USER_IsPERTestRunning(&deviceDesc)){
+			const uint16_t slot = SCPI_ETSI_TEST_GetSelectedPERSlot();
+			// check if any test is running at the moment on the selected PHY and antenna
+			if(false == SCPI_ETSI_TEST_USER_IsPERTestRunning(&deviceDesc, slot)){
+				// store result of the previous test before it is replaced
+				SCPI_ETSI_TEST_CollectPERResults();
 				// if not, try to start new test
-				if(true == SCPI_ETSI_TEST_USER_StartPERTest(&deviceDesc, testID)){
+				if(true == SCPI_ETSI_TEST_USER_StartPERTest(&deviceDesc, slot, testID)){
+					SCPI_ETSI_TEST_SetPERSlotDecision(slot);
+					if(slot < SCPI_ETSI_TEST_PER_MAX_SLOT_BITS){
+						perPendingSlots |= (uint32_t)1 << slot;
+					}
 					SCPI_ETSI_TEST_Send("OK\n", 3);
 					return SCPI_RES_OK;
 				}
@@ -843,11 +1865,10 @@ scpi_result_t SCPI_ETSI_TEST_StartPERTest(scpi_t* context){
 }
 
 scpi_result_t SCPI_ETSI_TEST_IsPERTestRunning(scpi_t* context){
-	if(NULL != context) {
-		char buffer[UINT8_BUFF_SIZE];
-		const bool testStatus = SCPI_ETSI_TEST_USER_IsPERTestRunning(&deviceDesc);
-		snprintf(buffer, sizeof(buffer), "%d\n", testStatus);
-		SCPI_ETSI_TEST_Send(buffer, strlen(buffer));
+	uint16_t slot;
+	if((NULL != context) && SCPI_ETSI_TEST_GetCommandPERSlot(context, &slot)) {
+		const bool testStatus = SCPI_ETSI_TEST_USER_IsPERTestRunning(&deviceDesc, slot);
+		SCPI_ETSI_TEST_SendNumber(context, testStatus);
 		return SCPI_RES_OK;
 	}
 	SCPI_ETSI_TEST_Send("ERR\n", 4);
@@ -855,11 +1876,259 @@ scpi_result_t SCPI_ETSI_TEST_IsPERTestRunning(scpi_t* context){
 }
 
 scpi_result_t SCPI_ETSI_TEST_GetPERTestResult(scpi_t* context){
+	uint16_t slot;
+	if((NULL != context) && SCPI_ETSI_TEST_GetCommandPERSlot(context, &slot)) {
+		uint32_t testID;
+		const SCPI_ETSI_TEST_PERTestResult* testResult = NULL;
+		SCPI_ETSI_TEST_PERDecision decision = SCPI_ETSI_TEST_GetSelectedPERDecision();
+		SCPI_ETSI_TEST_PERTestProgress progress;
+		bool running = false;
+		// result of given test ID is taken from history, otherwise the last result of the slot is sent
+		if(SCPI_ParamUInt32(context, &testID, FALSE)){
+			SCPI_ETSI_TEST_CollectPERResults();
+			testResult = SCPI_ETSI_TEST_GetPERHistory(testID, &decision);
+		} else if(!SCPI_ParamErrorOccurred(context)){
+			decision = SCPI_ETSI_TEST_GetPERSlotDecision(slot);
+			running = SCPI_ETSI_TEST_USER_IsPERTestRunning(&deviceDesc, slot);
+			if(running && !SCPI_ETSI_TEST_USER_GetPERTestProgress(&deviceDesc, slot, &progress)){
+				memset(&progress, 0, sizeof(progress));
+			}
+			testResult = SCPI_ETSI_TEST_USER_GetPERTestResult(&deviceDesc, slot);
+		}
+		if(SCPI_ETSI_TEST_SendPERTestResult(context, testResult, &decision, running ? &progress : NULL)){
+			return SCPI_RES_OK;
+		}
+	}
+	SCPI_ETSI_TEST_Send("ERR\n", 4);
+	return SCPI_RES_ERR;
+}
+
+scpi_result_t SCPI_ETSI_TEST_GetPERTestResultRange(scpi_t* context){
+	if(NULL != context) {
+		uint32_t first;
+		uint32_t last = UINT32_MAX;
+		// get test ID range from parser, the range is open ended when the last ID is omitted
+		if(SCPI_ParamUInt32(context, &first, TRUE)
+				&& (SCPI_ParamUInt32(context, &last, FALSE) || !SCPI_ParamErrorOccurred(context))
+				&& (first <= last)){
+			SCPI_ETSI_TEST_CollectPERResults();
+			size_t resultCount = 0;
+			for(uint16_t n=0; n < perHistoryCount; n++){
+				const uint16_t position = SCPI_ETSI_TEST_GetPERHistoryPosition(n);
+				const uint32_t testID = perHistory[position].testID;
+				if((testID >= first) && (testID <= last) && SCPI_ETSI_TEST_IsPERHistoryCurrent(position)){
+					resultCount++;
+				}
+			}
+			// test ID, total and received packets of every result in the order the tests finished
+			int64_t values[SCPI_ETSI_TEST_BLOCK_CHUNK];
+			size_t count = 0;
+			SCPI_ETSI_TEST_SendBlockHeader(context, resultCount * 3);
+			for(uint16_t n=0; n < perHistoryCount; n++){
+				const uint16_t position = SCPI_ETSI_TEST_GetPERHistoryPosition(n);
+				const SCPI_ETSI_TEST_PERTestResult* result = &perHistory[position];
+				if((result->testID >= first) && (result->testID <= last) && SCPI_ETSI_TEST_IsPERHistoryCurrent(position)){
+					if(count + 3 > SCPI_ETSI_TEST_BLOCK_CHUNK){
+						SCPI_ETSI_TEST_SendBlockValues(context, values, count);
+						count = 0;
+					}
+					values[count++] = result->testID;
+					values[count++] = result->totalPacketsNumber;
+					values[count++] = result->receivedPacketsNumber;
+				}
+			}
+			SCPI_ETSI_TEST_SendBlockValues(context, values, count);
+			return SCPI_RES_OK;
+		}
+	}
+	SCPI_ETSI_TEST_Send("ERR\n", 4);
+	return SCPI_RES_ERR;
+}
+
+scpi_result_t SCPI_ETSI_TEST_ClearPERTestResults(scpi_t* context){
+	if(NULL != context) {
+		SCPI_ETSI_TEST_ClearPERHistory();
+		SCPI_ETSI_TEST_Send("OK\n", 3);
+		return SCPI_RES_OK;
+	}
+	SCPI_ETSI_TEST_Send("ERR\n", 4);
+	return SCPI_RES_ERR;
+}
+
+scpi_result_t SCPI_ETSI_TEST_GetPERSweep(scpi_t* context){
+	if(NULL != context) {
+		uint32_t testID;
+		// get ID of the first test from parser
+		if(SCPI_ParamUInt32(context, &testID, TRUE) && (deviceDesc.phySettings.phyNumber < deviceDesc.phyCount)){
+			const SCPI_ETSI_TEST_PhyCapabilities* capabilities = &deviceDesc.phyCapabilities[deviceDesc.phySettings.phyNumber];
+			const size_t powerCount = (capabilities->highestPower >= capabilities->lowestPower) ? (size_t)(capabilities->highestPower - capabilities->lowestPower + 1) : 0;
+			const size_t pointCount = powerCount * capabilities->channelCount;
+			// sweep can be run only when no other test is running
+			if((pointCount > 0) && (false == SCPI_ETSI_TEST_USER_IsPERTestRunning(&deviceDesc, SCPI_ETSI_TEST_GetSelectedPERSlot()))){
+				// matrix of received packets: one row per channel, one column per power level, run and sent in batches
+				int64_t received[SCPI_ETSI_TEST_BLOCK_CHUNK];
+				bool success = true;
+				bool started = false;
+				for(size_t first=0; first < pointCount; first += SCPI_ETSI_TEST_PER_SWEEP_BATCH_POINTS){
+					const size_t batch = ((pointCount - first) < SCPI_ETSI_TEST_PER_SWEEP_BATCH_POINTS) ? (pointCount - first) : SCPI_ETSI_TEST_PER_SWEEP_BATCH_POINTS;
+					success = success && (SCPI_ETSI_TEST_USER_RunPERSweep(&deviceDesc, testID, first, batch, perSweepResults)
+							|| SCPI_ETSI_TEST_RunPERSweep(testID, powerCount, first, batch, perSweepResults));
+					if(!success && !started){
+						break;
+					}
+					if(!started){
+						SCPI_ETSI_TEST_SendBlockHeader(context, pointCount);
+						started = true;
+					}
+					// once the block is started it is completed, points of a failed batch are sent as 0
+					for(size_t point=0; point < batch; point += SCPI_ETSI_TEST_BLOCK_CHUNK){
+						const size_t count = ((batch - point) < SCPI_ETSI_TEST_BLOCK_CHUNK) ? (batch - point) : SCPI_ETSI_TEST_BLOCK_CHUNK;
+						for(size_t i=0; i < count; i++){
+							received[i] = success ? perSweepResults[point + i].receivedPacketsNumber : 0;
+						}
+						SCPI_ETSI_TEST_SendBlockValues(context, received, count);
+					}
+				}
+				if(success){
+					return SCPI_RES_OK;
+				}
+				if(started){
+					// block has been sent, the failure is reported by the error queue
+					return SCPI_RES_ERR;
+				}
+			}
+		}
+	}
+	SCPI_ETSI_TEST_Send("ERR\n", 4);
+	return SCPI_RES_ERR;
+}
+
+scpi_result_t SCPI_ETSI_TEST_GetSensitivity(scpi_t* context){
+	if(NULL != context) {
+		uint32_t limit;
+		uint32_t testID = 0;
+		// get PER limit and optional ID of the first test from parser
+		if(SCPI_ParamUInt32(context, &limit, TRUE) && (limit > 0) && (limit <= SCPI_ETSI_TEST_PPM)
+				&& (SCPI_ParamUInt32(context, &testID, FALSE) || !SCPI_ParamErrorOccurred(context))
+				&& (deviceDesc.phySettings.phyNumber < deviceDesc.phyCount)
+				&& (false == SCPI_ETSI_TEST_USER_IsPERTestRunning(&deviceDesc, SCPI_ETSI_TEST_GetSelectedPERSlot()))){
+			int8_t power;
+			uint64_t packets;
+			if(SCPI_ETSI_TEST_FindSensitivity(limit, testID, &power, &packets)){
+				const int64_t result[] = { power, (int64_t)packets };
+				SCPI_ETSI_TEST_SendNumbers(context, result, sizeof(result)/sizeof(result[0]));
+				return SCPI_RES_OK;
+			}
+		}
+	}
+	SCPI_ETSI_TEST_Send("ERR\n", 4);
+	return SCPI_RES_ERR;
+}
+
+scpi_result_t SCPI_ETSI_TEST_GetPERTestProgress(scpi_t* context){
+	uint16_t slot;
+	if((NULL != context) && SCPI_ETSI_TEST_GetCommandPERSlot(context, &slot)) {
+		int64_t values[5];
+		if(SCPI_ETSI_TEST_GetPERProgressValues(slot, values)){
+			SCPI_ETSI_TEST_SendNumbers(context, values, sizeof(values)/sizeof(values[0]));
+			return SCPI_RES_OK;
+		}
+	}
+	SCPI_ETSI_TEST_Send("ERR\n", 4);
+	return SCPI_RES_ERR;
+}
+
+scpi_result_t SCPI_ETSI_TEST_WaitPERTest(scpi_t* context){
+	uint16_t slot;
+	if((NULL != context) && SCPI_ETSI_TEST_GetCommandPERSlot(context, &slot)) {
+		uint32_t timeout;
+		// get maximal waiting time in ms from parser
+		if(SCPI_ParamUInt32(context, &timeout, TRUE) && SCPI_ETSI_TEST_WaitForPERTest(slot, timeout)){
+			const SCPI_ETSI_TEST_PERDecision decision = SCPI_ETSI_TEST_GetPERSlotDecision(slot);
+			if(SCPI_ETSI_TEST_SendPERTestResult(context, SCPI_ETSI_TEST_USER_GetPERTestResult(&deviceDesc, slot), &decision, NULL)){
+				return SCPI_RES_OK;
+			}
+		}
+	}
+	SCPI_ETSI_TEST_Send("ERR\n", 4);
+	return SCPI_RES_ERR;
+}
+
+scpi_result_t SCPI_ETSI_TEST_SetPERProgressPush(scpi_t* context){
+	if(NULL != context) {
+		uint32_t interval;
+		// get report interval in ms from parser, 0 disables reports
+		if(SCPI_ParamUInt32(context, &interval, TRUE)){
+			perPushInterval = interval;
+			perPushTime = SCPI_ETSI_TEST_USER_GetTime();
+			perPushSlots = 0;
+			SCPI_ETSI_TEST_Send("OK\n", 3);
+			return SCPI_RES_OK;
+		}
+	}
+	SCPI_ETSI_TEST_Send("ERR\n", 4);
+	return SCPI_RES_ERR;
+}
+
+scpi_result_t SCPI_ETSI_TEST_GetPERProgressPush(scpi_t* context){
+	if(NULL != context) {
+		SCPI_ETSI_TEST_SendNumber(context, perPushInterval);
+		return SCPI_RES_OK;
+	}
+	SCPI_ETSI_TEST_Send("ERR\n", 4);
+	return SCPI_RES_ERR;
+}
+
+scpi_result_t SCPI_ETSI_TEST_SetDataFormat(scpi_t* context){
+	if(NULL != context) {
+		int32_t format;
+		// get data format name from parser
+		if(SCPI_ParamChoice(context, dataFormats, &format, TRUE)){
+			dataFormat = format;
+			SCPI_ETSI_TEST_Send("OK\n", 3);
+			return SCPI_RES_OK;
+		}
+	}
+	SCPI_ETSI_TEST_Send("ERR\n", 4);
+	return SCPI_RES_ERR;
+}
+
+scpi_result_t SCPI_ETSI_TEST_GetDataFormat(scpi_t* context){
 	if(NULL != context) {
 		char buffer[STRING_BUFF_SIZE];
-		SCPI_ETSI_TEST_PERTestResult* testResult = SCPI_ETSI_TEST_USER_GetPERTestResult(&deviceDesc);
-		if(NULL != testResult){
-			snprintf(buffer, sizeof(buffer), "%"PRIu32",%"PRIu16",%"PRIu16"\n", testResult->testID, testResult->totalPacketsNumber, testResult->receivedPacketsNumber);
+		const char* name;
+		if(SCPI_ChoiceToName(dataFormats, dataFormat, &name)){
+			// respond with short form of the name
+			snprintf(buffer, sizeof(buffer), "%.*s\n", (int)strcspn(name, "abcdefghijklmnopqrstuvwxyz"), name);
+			SCPI_ETSI_TEST_Send(buffer, strlen(buffer));
+			return SCPI_RES_OK;
+		}
+	}
+	SCPI_ETSI_TEST_Send("ERR\n", 4);
+	return SCPI_RES_ERR;
+}
+
+scpi_result_t SCPI_ETSI_TEST_SetByteOrder(scpi_t* context){
+	if(NULL != context) {
+		int32_t order;
+		// get byte order name from parser
+		if(SCPI_ParamChoice(context, byteOrders, &order, TRUE)){
+			byteOrder = order;
+			SCPI_ETSI_TEST_Send("OK\n", 3);
+			return SCPI_RES_OK;
+		}
+	}
+	SCPI_ETSI_TEST_Send("ERR\n", 4);
+	return SCPI_RES_ERR;
+}
+
+scpi_result_t SCPI_ETSI_TEST_GetByteOrder(scpi_t* context){
+	if(NULL != context) {
+		char buffer[STRING_BUFF_SIZE];
+		const char* name;
+		if(SCPI_ChoiceToName(byteOrders, byteOrder, &name)){
+			// respond with short form of the name
+			snprintf(buffer, sizeof(buffer), "%.*s\n", (int)strcspn(name, "abcdefghijklmnopqrstuvwxyz"), name);
 			SCPI_ETSI_TEST_Send(buffer, strlen(buffer));
 			return SCPI_RES_OK;
 		}
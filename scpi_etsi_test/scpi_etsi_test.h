@@ -18,13 +18,29 @@ typedef enum{
 	SCPI_ERROR = 1,
 }SCPIResult;
 
+/** PER test verdict against the PER limit */
+typedef enum{
+	SCPI_ETSI_TEST_PER_UNDECIDED = 0,
+	SCPI_ETSI_TEST_PER_PASS = 1,
+	SCPI_ETSI_TEST_PER_FAIL = 2,
+}SCPI_ETSI_TEST_PERVerdict;
+
 /** PER test result descriptor */
 typedef struct{
 	uint32_t testID;
-	uint16_t totalPacketsNumber;
-	uint16_t receivedPacketsNumber;
+	uint32_t totalPacketsNumber;
+	uint32_t receivedPacketsNumber;
 }SCPI_ETSI_TEST_PERTestResult;
 
+/** PER test progress descriptor */
+typedef struct{
+	uint32_t testID;
+	uint32_t totalPacketsNumber;
+	uint32_t sentPacketsNumber;
+	uint32_t receivedPacketsNumber;
+	uint32_t remainingTime;		// estimated time to the end of PER test in ms
+}SCPI_ETSI_TEST_PERTestProgress;
+
 /** PHY setting descriptor */
 typedef struct{
 	uint8_t phyNumber;
@@ -32,8 +48,11 @@ typedef struct{
 	int8_t power;
 	uint8_t signalType;
 	uint8_t antennaNumber;
-	uint16_t perTotalPacketsNumber;
+	uint32_t perTotalPacketsNumber;
 	uint16_t perPacketLength;
+	uint32_t perSeed;
+	uint32_t perLimit;			// PER limit in ppm, 0 runs all packets of PER test
+	uint32_t perConfidence;		// confidence level of PER limit decision in ppm
 }SCPI_ETSI_TEST_PhySettings;
 
 /** PHY capabilities descriptor */
@@ -55,7 +74,7 @@ typedef struct{
 	uint8_t defaultSignalType;
 	int8_t defaultPower;
 	uint8_t defaultAntennaNumber;
-	uint16_t defaultPERTotalPacketsNumber;
+	uint32_t defaultPERTotalPacketsNumber;
 	uint16_t defaultPERPacketLength;
 }SCPI_ETSI_TEST_PhyCapabilities;
 
@@ -95,4 +114,27 @@ SCPIResult SCPI_ETSI_TEST_Proc(void);
 */
 void SCPI_ETSI_TEST_Send(const void* data, size_t size);
 
+/**
+ *  Calculates Wilson score interval of the packet error rate and decides PER test against
+ *  the PER limit of given settings. A backend running sequential PER tests may stop the test
+ *  as soon as the verdict is decided.
+ *
+ *  @param[in] settings - PHY settings with PER limit and confidence level
+ *  @param[in] sentPackets - number of packets sent so far
+ *  @param[in] receivedPackets - number of packets received so far
+ *  @param[out] lower - lower bound of the packet error rate in ppm, may be NULL
+ *  @param[out] upper - upper bound of the packet error rate in ppm, may be NULL
+ *  @return verdict, SCPI_ETSI_TEST_PER_UNDECIDED when the PER limit is not set
+*/
+SCPI_ETSI_TEST_PERVerdict SCPI_ETSI_TEST_GetPERVerdict(const SCPI_ETSI_TEST_PhySettings* settings, uint32_t sentPackets,
+		uint32_t receivedPackets, uint32_t* lower, uint32_t* upper);
+
+/**
+ *  Notifies the parser that PER test of given slot finished, wakes PER:WAIT? up. Called by the
+ *  user implementation, it may be called from interrupt context.
+ *
+ *  @param[in] slot - PER test slot
+*/
+void SCPI_ETSI_TEST_PERTestFinished(uint16_t slot);
+
 #endif /* SCPI_ETSI_TEST_H_ */
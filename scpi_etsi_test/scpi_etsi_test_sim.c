@@ -0,0 +1,502 @@
+/**
+@file
+@license   $License$
+@copyright $Copyright$
+@version   $Revision$
+@purpose   SCPI ETSI TEST simulated radio backend
+@brief     Simulated transceiver implementing the SCPI ETSI TEST user interface
+*/
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#if defined(_POSIX_THREADS) && (_POSIX_THREADS > 0)
+#include <pthread.h>
+#endif
+#include "scpi_etsi_test.h"
+#include "scpi_etsi_test_user.h"
+#include "scpi_etsi_test_sim.h"
+#include "scpi_etsi_test_sim_per.h"
+
+// transceiver modes set by TRXmode command
+enum {
+	TRX_MODE_OFF = 0,
+	TRX_MODE_TX = 1,
+	TRX_MODE_RX = 2,
+};
+
+enum {
+	// number of outcome words decided at once when catching up with elapsed time
+	SCPI_ETSI_TEST_SIM_BATCH_WORDS = 64,
+	// number of threads computing PER sweep points
+	SCPI_ETSI_TEST_SIM_SWEEP_THREADS = 4,
+	// number of PER tests (PHY and antenna slots) run at the same time
+	SCPI_ETSI_TEST_SIM_PER_SLOTS = 8,
+};
+
+// default channel model: SNR about 12 dB on channel 0 at 0 dBm
+static const SCPI_ETSI_TEST_SIM_ChannelModel defaultModel = {
+	.noiseFloor = -114.0f,
+	.pathLoss = 102.0f,
+	.pathLossStep = 0.5f,
+	.packetLossProbability = 0.001f,
+	.overheadBits = 64,
+	.interPacketGap = 1000,
+	.timeScale = 1.0f,
+};
+
+// outcome bit stream of one PER test
+typedef struct{
+	uint64_t threshold;
+	uint64_t outcomes;
+	uint8_t outcomesLeft;
+	SCPI_ETSI_TEST_SIM_PER_Generator generator;
+}SCPI_ETSI_TEST_SIM_PacketStream;
+
+// state of the simulated PER test
+typedef struct{
+	bool running;
+	uint32_t testID;
+	uint32_t totalPackets;
+	uint32_t processedPackets;
+	uint32_t receivedPackets;
+	uint64_t startTime;
+	uint64_t packetTime;
+	SCPI_ETSI_TEST_PhySettings settings;
+	SCPI_ETSI_TEST_SIM_PacketStream stream;
+}SCPI_ETSI_TEST_SIM_PERTest;
+
+// work shared by PER sweep threads
+typedef struct{
+	const SCPI_ETSI_TEST_PhyCapabilities* capabilities;
+	SCPI_ETSI_TEST_PhySettings settings;
+	uint32_t testID;
+	size_t powerCount;
+	size_t firstPoint;
+	size_t pointCount;
+	SCPI_ETSI_TEST_PERTestResult* results;
+}SCPI_ETSI_TEST_SIM_Sweep;
+
+// PER sweep thread arguments
+typedef struct{
+	const SCPI_ETSI_TEST_SIM_Sweep* sweep;
+	size_t first;
+}SCPI_ETSI_TEST_SIM_SweepWorker;
+
+// channel model in use
+static SCPI_ETSI_TEST_SIM_ChannelModel model;
+// current transceiver mode
+static uint8_t trxMode;
+// PER test being run or finished last in every slot
+static SCPI_ETSI_TEST_SIM_PERTest perTests[SCPI_ETSI_TEST_SIM_PER_SLOTS];
+// results reported by GetPERTestResult
+static SCPI_ETSI_TEST_PERTestResult testResults[SCPI_ETSI_TEST_SIM_PER_SLOTS];
+
+/**
+ *  Gets monotonic time.
+ *
+ *  @return time in us
+*/
+static uint64_t SCPI_ETSI_TEST_SIM_Now(void){
+#if defined(CLOCK_MONOTONIC)
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000000u + (uint64_t)now.tv_nsec / 1000u;
+#else
+	return (uint64_t)time(NULL) * 1000000u;
+#endif
+}
+
+/**
+ *  Decides outcomes of the next packets of the stream. Outcomes are consumed as one bit
+ *  stream, so the result does not depend on how the packets are split between calls.
+ *
+ *  @param[inout] stream - packet stream
+ *  @param[in] packets - number of packets to decide
+ *  @return number of received packets
+*/
+static uint32_t SCPI_ETSI_TEST_SIM_Receive(SCPI_ETSI_TEST_SIM_PacketStream* stream, uint32_t packets){
+	uint32_t received = 0;
+	while(packets > 0){
+		if(0 == stream->outcomesLeft){
+			if(packets >= SCPI_ETSI_TEST_SIM_PER_WORD_BITS){
+				uint64_t bitmap[SCPI_ETSI_TEST_SIM_BATCH_WORDS];
+				size_t words = packets / SCPI_ETSI_TEST_SIM_PER_WORD_BITS;
+				if(words > SCPI_ETSI_TEST_SIM_BATCH_WORDS){
+					words = SCPI_ETSI_TEST_SIM_BATCH_WORDS;
+				}
+				SCPI_ETSI_TEST_SIM_PER_Sample(&stream->generator, stream->threshold, bitmap, words);
+				received += (uint32_t)SCPI_ETSI_TEST_SIM_PER_Count(bitmap, words);
+				packets -= (uint32_t)(words * SCPI_ETSI_TEST_SIM_PER_WORD_BITS);
+				continue;
+			}
+			SCPI_ETSI_TEST_SIM_PER_Sample(&stream->generator, stream->threshold, &stream->outcomes, 1);
+			stream->outcomesLeft = SCPI_ETSI_TEST_SIM_PER_WORD_BITS;
+		}
+		const uint32_t count = (packets < stream->outcomesLeft) ? packets : stream->outcomesLeft;
+		const uint64_t mask = (SCPI_ETSI_TEST_SIM_PER_WORD_BITS == count) ? ~0ull : ((1ull << count) - 1);
+		received += SCPI_ETSI_TEST_SIM_PER_Popcount(stream->outcomes & mask);
+		stream->outcomes = (SCPI_ETSI_TEST_SIM_PER_WORD_BITS == count) ? 0 : (stream->outcomes >> count);
+		stream->outcomesLeft -= (uint8_t)count;
+		packets -= count;
+	}
+	return received;
+}
+
+/**
+ *  Prepares packet stream of PER test run with given settings.
+ *
+ *  @param[out] stream - packet stream
+ *  @param[in] capabilities - capabilities of the PHY in use
+ *  @param[in] settings - PHY settings
+ *  @param[in] testID - PER test ID
+ *  @return packet time in us
+*/
+static uint32_t SCPI_ETSI_TEST_SIM_OpenStream(SCPI_ETSI_TEST_SIM_PacketStream* stream, const SCPI_ETSI_TEST_PhyCapabilities* capabilities,
+		const SCPI_ETSI_TEST_PhySettings* settings, uint32_t testID){
+	const float snr = SCPI_ETSI_TEST_SIM_GetSNR(&model, settings->channelNumber, settings->power);
+	stream->threshold = SCPI_ETSI_TEST_SIM_PER_Threshold(SCPI_ETSI_TEST_SIM_GetPacketErrorProbability(&model, snr, settings->perPacketLength));
+	stream->outcomes = 0;
+	stream->outcomesLeft = 0;
+	SCPI_ETSI_TEST_SIM_PER_Seed(&stream->generator, settings->perSeed, testID);
+	return SCPI_ETSI_TEST_SIM_GetPacketTime(&model, capabilities->baudrate, settings->perPacketLength);
+}
+
+/**
+ *  Calculates time when running PER test should be simulated again: when the test ends, or when
+ *  the next outcome word is complete if the PER limit verdict may stop it earlier.
+ *
+ *  @param[in] perTest - running PER test
+ *  @return time in us
+*/
+static uint64_t SCPI_ETSI_TEST_SIM_GetUpdateTime(const SCPI_ETSI_TEST_SIM_PERTest* perTest){
+	uint32_t packets = perTest->totalPackets;
+	if(0 != perTest->settings.perLimit){
+		const uint32_t word = perTest->processedPackets / SCPI_ETSI_TEST_SIM_PER_WORD_BITS + 1;
+		if(word < packets / SCPI_ETSI_TEST_SIM_PER_WORD_BITS){
+			packets = word * SCPI_ETSI_TEST_SIM_PER_WORD_BITS;
+		}
+	}
+	return perTest->startTime + (uint64_t)ceil((double)packets * perTest->packetTime * model.timeScale);
+}
+
+/**
+ *  Receives packets of PER test up to the target. With PER limit set the test is sequential:
+ *  it stops as soon as the verdict is decided, which is checked every outcome word.
+ *
+ *  @param[inout] stream - packet outcome stream of the test
+ *  @param[in] settings - settings of the test
+ *  @param[in] target - number of packets to be processed
+ *  @param[inout] processed - number of packets processed
+ *  @param[inout] received - number of packets received
+ *  @return true when the test has been stopped by the verdict, false otherwise
+*/
+static bool SCPI_ETSI_TEST_SIM_ReceiveSequential(SCPI_ETSI_TEST_SIM_PacketStream* stream, const SCPI_ETSI_TEST_PhySettings* settings,
+		uint32_t target, uint32_t* processed, uint32_t* received){
+	if(0 == settings->perLimit){
+		*received += SCPI_ETSI_TEST_SIM_Receive(stream, target - *processed);
+		*processed = target;
+		return false;
+	}
+	while(*processed < target){
+		const uint32_t remaining = target - *processed;
+		const uint32_t count = (remaining < SCPI_ETSI_TEST_SIM_PER_WORD_BITS) ? remaining : SCPI_ETSI_TEST_SIM_PER_WORD_BITS;
+		*received += SCPI_ETSI_TEST_SIM_Receive(stream, count);
+		*processed += count;
+		if(SCPI_ETSI_TEST_PER_UNDECIDED != SCPI_ETSI_TEST_GetPERVerdict(settings, *processed, *received, NULL, NULL)){
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ *  Simulates packets of running PER test which air time has already elapsed. Tests of
+ *  different slots run independently, each one on its own time base.
+ *
+ *  @param[inout] perTest - PER test
+*/
+static void SCPI_ETSI_TEST_SIM_Update(SCPI_ETSI_TEST_SIM_PERTest* perTest){
+	if(perTest->running){
+		uint32_t target = perTest->totalPackets;
+		if((model.timeScale > 0) && (perTest->packetTime > 0)){
+			const double elapsed = (double)(SCPI_ETSI_TEST_SIM_Now() - perTest->startTime) / model.timeScale;
+			const double packets = elapsed / (double)perTest->packetTime;
+			if(packets < target){
+				target = (uint32_t)packets;
+			}
+		}
+		if(SCPI_ETSI_TEST_SIM_ReceiveSequential(&perTest->stream, &perTest->settings, target, &perTest->processedPackets, &perTest->receivedPackets)){
+			perTest->totalPackets = perTest->processedPackets;
+		}
+		if(perTest->processedPackets == perTest->totalPackets){
+			perTest->running = false;
+		}
+		if(!perTest->running){
+			SCPI_ETSI_TEST_PERTestFinished((uint16_t)(perTest - perTests));
+		}
+	}
+}
+
+void SCPI_ETSI_TEST_SIM_Init(const SCPI_ETSI_TEST_SIM_ChannelModel* channelModel){
+	model = (NULL != channelModel) ? *channelModel : defaultModel;
+	trxMode = TRX_MODE_OFF;
+	memset(perTests, 0, sizeof(perTests));
+	memset(testResults, 0, sizeof(testResults));
+}
+
+SCPI_ETSI_TEST_SIM_ChannelModel* SCPI_ETSI_TEST_SIM_GetModel(void){
+	return &model;
+}
+
+float SCPI_ETSI_TEST_SIM_GetSNR(const SCPI_ETSI_TEST_SIM_ChannelModel* channelModel, uint16_t channel, int8_t power){
+	return (float)power - (channelModel->pathLoss + channelModel->pathLossStep * channel) - channelModel->noiseFloor;
+}
+
+double SCPI_ETSI_TEST_SIM_GetPacketErrorProbability(const SCPI_ETSI_TEST_SIM_ChannelModel* channelModel, float snr, uint16_t packetLength){
+	// non-coherent binary FSK: BER = 1/2 * exp(-Eb/N0 / 2)
+	const double ber = 0.5 * exp(-pow(10.0, snr / 10.0) / 2.0);
+	const double bits = 8.0 * packetLength + channelModel->overheadBits;
+	const double success = pow(1.0 - ber, bits) * (1.0 - channelModel->packetLossProbability);
+	return 1.0 - success;
+}
+
+uint32_t SCPI_ETSI_TEST_SIM_GetPacketTime(const SCPI_ETSI_TEST_SIM_ChannelModel* channelModel, uint32_t baudrate, uint16_t packetLength){
+	if(0 == baudrate){
+		return channelModel->interPacketGap;
+	}
+	const uint64_t bits = 8u * (uint64_t)packetLength + channelModel->overheadBits;
+	return (uint32_t)((bits * 1000000u + baudrate - 1) / baudrate) + channelModel->interPacketGap;
+}
+
+/**
+ *  Computes every SCPI_ETSI_TEST_SIM_SWEEP_THREADS-th point of PER sweep batch, starting at given point.
+ *
+ *  @param[in] argument - SCPI_ETSI_TEST_SIM_SweepWorker
+ *  @return NULL
+*/
+static void* SCPI_ETSI_TEST_SIM_SweepThread(void* argument){
+	const SCPI_ETSI_TEST_SIM_SweepWorker* worker = argument;
+	const SCPI_ETSI_TEST_SIM_Sweep* sweep = worker->sweep;
+	SCPI_ETSI_TEST_PhySettings settings = sweep->settings;
+	SCPI_ETSI_TEST_SIM_PacketStream stream;
+	for(size_t i = worker->first; i < sweep->pointCount; i += SCPI_ETSI_TEST_SIM_SWEEP_THREADS){
+		const size_t point = sweep->firstPoint + i;
+		const uint32_t testID = sweep->testID + (uint32_t)point;
+		settings.channelNumber = (uint16_t)(point / sweep->powerCount);
+		settings.power = (int8_t)(sweep->capabilities->lowestPower + (int)(point % sweep->powerCount));
+		uint32_t processed = 0;
+		uint32_t received = 0;
+		SCPI_ETSI_TEST_SIM_OpenStream(&stream, sweep->capabilities, &settings, testID);
+		SCPI_ETSI_TEST_SIM_ReceiveSequential(&stream, &settings, settings.perTotalPacketsNumber, &processed, &received);
+		sweep->results[i].testID = testID;
+		sweep->results[i].totalPacketsNumber = processed;
+		sweep->results[i].receivedPacketsNumber = received;
+	}
+	return NULL;
+}
+
+/**
+ * Resets the simulated transceiver. Running PER tests are aborted.
+ * @param[inout] deviceDescriptor pointer to the device descriptor structure
+ */
+void SCPI_ETSI_TEST_USER_Reset(SCPI_ETSI_TEST_DeviceDescriptor* deviceDescriptor){
+	(void)deviceDescriptor;
+	trxMode = TRX_MODE_OFF;
+	for(size_t slot = 0; slot < SCPI_ETSI_TEST_SIM_PER_SLOTS; slot++){
+		perTests[slot].running = false;
+	}
+}
+
+/**
+ * Sets the transceiver mode of operation
+ * @param[inout] deviceDescriptor pointer to the device descriptor structure
+ * @param[in] mode number describing transceiver operation mode
+ * @return true on success, false otherwise
+ */
+bool SCPI_ETSI_TEST_USER_SetTRXMode(SCPI_ETSI_TEST_DeviceDescriptor* deviceDescriptor, uint8_t mode){
+	(void)deviceDescriptor;
+	if(mode <= TRX_MODE_RX){
+		trxMode = mode;
+		return true;
+	}
+	return false;
+}
+
+/**
+ * Starts simulated PER test using the selected PHY settings. Packets are simulated as their
+ * air time elapses (scaled by the model time scale), tests of different slots run concurrently.
+ * Outcomes are reproducible from the PER seed and the test ID. When PER limit is set, the test
+ * stops as soon as the verdict is decided and the number of packets sent so far becomes its total.
+ * @param[inout] deviceDescriptor pointer to the device descriptor structure
+ * @param[in] slot PER test slot of the selected PHY and antenna
+ * @param[in] testID identification number of PER test
+ * @return true on success, false otherwise
+ */
+bool SCPI_ETSI_TEST_USER_StartPERTest(SCPI_ETSI_TEST_DeviceDescriptor* deviceDescriptor, uint16_t slot, uint32_t testID){
+	if((NULL != deviceDescriptor) && (slot < SCPI_ETSI_TEST_SIM_PER_SLOTS)){
+		const SCPI_ETSI_TEST_PhySettings* settings = &deviceDescriptor->phySettings;
+		if(settings->phyNumber < deviceDescriptor->phyCount){
+			const SCPI_ETSI_TEST_PhyCapabilities* capabilities = &deviceDescriptor->phyCapabilities[settings->phyNumber];
+			SCPI_ETSI_TEST_SIM_PERTest* perTest = &perTests[slot];
+			memset(perTest, 0, sizeof(*perTest));
+			perTest->testID = testID;
+			perTest->totalPackets = settings->perTotalPacketsNumber;
+			perTest->settings = *settings;
+			perTest->packetTime = SCPI_ETSI_TEST_SIM_OpenStream(&perTest->stream, capabilities, settings, testID);
+			perTest->startTime = SCPI_ETSI_TEST_SIM_Now();
+			perTest->running = true;
+			SCPI_ETSI_TEST_SIM_Update(perTest);
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Checks if simulated PER test of given slot is still running.
+ * @param[inout] deviceDescriptor pointer to the device descriptor structure
+ * @param[in] slot PER test slot
+ * @return true when PER test is running in the slot, false otherwise
+ */
+bool SCPI_ETSI_TEST_USER_IsPERTestRunning(SCPI_ETSI_TEST_DeviceDescriptor* deviceDescriptor, uint16_t slot){
+	(void)deviceDescriptor;
+	if(slot < SCPI_ETSI_TEST_SIM_PER_SLOTS){
+		SCPI_ETSI_TEST_SIM_Update(&perTests[slot]);
+		return perTests[slot].running;
+	}
+	return false;
+}
+
+/**
+ * Gets the result of the last simulated PER test of given slot. While the test is running,
+ * packets simulated so far are counted as received.
+ * @param[inout] deviceDescriptor pointer to the device descriptor structure
+ * @param[in] slot PER test slot
+ * @return address of structure storing information about PER test result, NULL for unknown slot
+ */
+SCPI_ETSI_TEST_PERTestResult* SCPI_ETSI_TEST_USER_GetPERTestResult(SCPI_ETSI_TEST_DeviceDescriptor* deviceDescriptor, uint16_t slot){
+	(void)deviceDescriptor;
+	if(slot < SCPI_ETSI_TEST_SIM_PER_SLOTS){
+		SCPI_ETSI_TEST_SIM_PERTest* perTest = &perTests[slot];
+		SCPI_ETSI_TEST_SIM_Update(perTest);
+		testResults[slot].testID = perTest->testID;
+		testResults[slot].totalPacketsNumber = perTest->totalPackets;
+		testResults[slot].receivedPacketsNumber = perTest->receivedPackets;
+		return &testResults[slot];
+	}
+	return NULL;
+}
+
+/**
+ * Gets progress of the simulated PER test of given slot.
+ * @param[inout] deviceDescriptor pointer to the device descriptor structure
+ * @param[in] slot PER test slot
+ * @param[out] progress PER test progress
+ * @return true on success, false for unknown slot
+ */
+bool SCPI_ETSI_TEST_USER_GetPERTestProgress(SCPI_ETSI_TEST_DeviceDescriptor* deviceDescriptor, uint16_t slot, SCPI_ETSI_TEST_PERTestProgress* progress){
+	(void)deviceDescriptor;
+	if((slot < SCPI_ETSI_TEST_SIM_PER_SLOTS) && (NULL != progress)){
+		const SCPI_ETSI_TEST_SIM_PERTest* perTest = &perTests[slot];
+		SCPI_ETSI_TEST_SIM_Update(&perTests[slot]);
+		*progress = (SCPI_ETSI_TEST_PERTestProgress){
+			.testID = perTest->testID,
+			.totalPacketsNumber = perTest->totalPackets,
+			.sentPacketsNumber = perTest->processedPackets,
+			.receivedPacketsNumber = perTest->receivedPackets,
+		};
+		if(perTest->running){
+			const double remaining = (double)(perTest->totalPackets - perTest->processedPackets) * perTest->packetTime * model.timeScale / 1000.0;
+			progress->remainingTime = (remaining < UINT32_MAX) ? (uint32_t)ceil(remaining) : UINT32_MAX;
+		}
+		return true;
+	}
+	return false;
+}
+
+/**
+ * Sleeps until a simulated PER test may finish or the timeout elapses. Simulated tests finish
+ * only when they are updated, so they are updated after sleeping and notify their completion then.
+ * @param[in] timeout maximal waiting time in ms
+ */
+void SCPI_ETSI_TEST_USER_WaitForEvent(uint32_t timeout){
+	const uint64_t now = SCPI_ETSI_TEST_SIM_Now();
+	uint64_t wakeTime = now + (uint64_t)timeout * 1000u;
+	for(size_t slot = 0; slot < SCPI_ETSI_TEST_SIM_PER_SLOTS; slot++){
+		if(perTests[slot].running){
+			const uint64_t updateTime = SCPI_ETSI_TEST_SIM_GetUpdateTime(&perTests[slot]);
+			if(updateTime < wakeTime){
+				wakeTime = updateTime;
+			}
+		}
+	}
+	if(wakeTime > now){
+		const uint64_t wait = wakeTime - now;
+		const struct timespec duration = { .tv_sec = (time_t)(wait / 1000000u), .tv_nsec = (long)(wait % 1000000u) * 1000 };
+		nanosleep(&duration, NULL);
+	}
+	for(size_t slot = 0; slot < SCPI_ETSI_TEST_SIM_PER_SLOTS; slot++){
+		SCPI_ETSI_TEST_SIM_Update(&perTests[slot]);
+	}
+}
+
+/**
+ * Runs batch of simulated PER sweep. Grid points are independent Monte Carlo runs spread across
+ * SCPI_ETSI_TEST_SIM_SWEEP_THREADS threads, each giving the same result as PER test with the same
+ * settings and test ID. With PER limit set a point stops as soon as its verdict is decided, its
+ * total packets are the packets processed. The timing model is not applied.
+ * @param[inout] deviceDescriptor pointer to the device descriptor structure
+ * @param[in] testID identification number of the PER test of grid point 0
+ * @param[in] firstPoint index of the first grid point of the batch
+ * @param[in] pointCount number of grid points of the batch
+ * @param[out] results array of PER test results of the batch, ordered by channel, then by power
+ * @return true on success, false otherwise
+ */
+bool SCPI_ETSI_TEST_USER_RunPERSweep(SCPI_ETSI_TEST_DeviceDescriptor* deviceDescriptor, uint32_t testID, size_t firstPoint,
+		size_t pointCount, SCPI_ETSI_TEST_PERTestResult* results){
+	if((NULL == deviceDescriptor) || (NULL == results) || (deviceDescriptor->phySettings.phyNumber >= deviceDescriptor->phyCount)){
+		return false;
+	}
+	SCPI_ETSI_TEST_SIM_Sweep sweep = {
+		.capabilities = &deviceDescriptor->phyCapabilities[deviceDescriptor->phySettings.phyNumber],
+		.settings = deviceDescriptor->phySettings,
+		.testID = testID,
+		.firstPoint = firstPoint,
+		.pointCount = pointCount,
+		.results = results,
+	};
+	sweep.powerCount = (size_t)(sweep.capabilities->highestPower - sweep.capabilities->lowestPower + 1);
+	if(firstPoint + pointCount > sweep.powerCount * sweep.capabilities->channelCount){
+		return false;
+	}
+	SCPI_ETSI_TEST_SIM_SweepWorker workers[SCPI_ETSI_TEST_SIM_SWEEP_THREADS];
+	for(size_t i = 0; i < SCPI_ETSI_TEST_SIM_SWEEP_THREADS; i++){
+		workers[i].sweep = &sweep;
+		workers[i].first = i;
+	}
+#if defined(_POSIX_THREADS) && (_POSIX_THREADS > 0)
+	pthread_t threads[SCPI_ETSI_TEST_SIM_SWEEP_THREADS];
+	bool started[SCPI_ETSI_TEST_SIM_SWEEP_THREADS];
+	for(size_t i = 0; i < SCPI_ETSI_TEST_SIM_SWEEP_THREADS; i++){
+		started[i] = (0 == pthread_create(&threads[i], NULL, SCPI_ETSI_TEST_SIM_SweepThread, &workers[i]));
+	}
+	for(size_t i = 0; i < SCPI_ETSI_TEST_SIM_SWEEP_THREADS; i++){
+		if(started[i]){
+			pthread_join(threads[i], NULL);
+		} else{
+			// thread could not be created, compute its share here
+			SCPI_ETSI_TEST_SIM_SweepThread(&workers[i]);
+		}
+	}
+#else
+	for(size_t i = 0; i < SCPI_ETSI_TEST_SIM_SWEEP_THREADS; i++){
+		SCPI_ETSI_TEST_SIM_SweepThread(&workers[i]);
+	}
+#endif
+	return true;
+}
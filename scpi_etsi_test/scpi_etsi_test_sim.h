@@ -0,0 +1,71 @@
+/**
+@file
+@license   $License$
+@copyright $Copyright$
+@version   $Revision$
+@purpose   SCPI ETSI TEST simulated radio backend
+@brief     Simulated transceiver implementing the SCPI ETSI TEST user interface
+*/
+
+#ifndef SCPI_ETSI_TEST_SIM_H
+#define SCPI_ETSI_TEST_SIM_H
+
+#include "scpi_etsi_test.h"
+
+/** channel and timing model of the simulated transceiver */
+typedef struct{
+	float noiseFloor;				// receiver noise floor in dBm
+	float pathLoss;					// path loss of channel 0 in dB
+	float pathLossStep;				// additional path loss per channel number in dB
+	float packetLossProbability;	// probability of losing packet regardless of SNR (collisions, interference)
+	uint16_t overheadBits;			// preamble, sync word, header and CRC bits sent with each packet
+	uint32_t interPacketGap;		// gap between two packets in us
+	float timeScale;				// 1.0 runs PER test in real time, 0 finishes it immediately
+}SCPI_ETSI_TEST_SIM_ChannelModel;
+
+/**
+ *  Initializes the simulated transceiver.
+ *
+ *  @param[in] model - channel model to use or NULL for the default one
+*/
+void SCPI_ETSI_TEST_SIM_Init(const SCPI_ETSI_TEST_SIM_ChannelModel* model);
+
+/**
+ *  Gets the channel model used by the simulated transceiver. It may be modified at any time,
+ *  changes apply to PER tests started afterwards.
+ *
+ *  @return address of the channel model
+*/
+SCPI_ETSI_TEST_SIM_ChannelModel* SCPI_ETSI_TEST_SIM_GetModel(void);
+
+/**
+ *  Calculates signal to noise ratio at the receiver.
+ *
+ *  @param[in] model - channel model
+ *  @param[in] channel - channel number
+ *  @param[in] power - transmit power in dBm
+ *  @return SNR in dB
+*/
+float SCPI_ETSI_TEST_SIM_GetSNR(const SCPI_ETSI_TEST_SIM_ChannelModel* model, uint16_t channel, int8_t power);
+
+/**
+ *  Calculates probability that packet is not received, using bit error rate of non-coherent FSK.
+ *
+ *  @param[in] model - channel model
+ *  @param[in] snr - signal to noise ratio in dB
+ *  @param[in] packetLength - packet payload length in bytes
+ *  @return packet error probability (0 to 1)
+*/
+double SCPI_ETSI_TEST_SIM_GetPacketErrorProbability(const SCPI_ETSI_TEST_SIM_ChannelModel* model, float snr, uint16_t packetLength);
+
+/**
+ *  Calculates air time of one packet including the inter-packet gap.
+ *
+ *  @param[in] model - channel model
+ *  @param[in] baudrate - PHY baudrate in bits per second
+ *  @param[in] packetLength - packet payload length in bytes
+ *  @return packet time in us
+*/
+uint32_t SCPI_ETSI_TEST_SIM_GetPacketTime(const SCPI_ETSI_TEST_SIM_ChannelModel* model, uint32_t baudrate, uint16_t packetLength);
+
+#endif /* SCPI_ETSI_TEST_SIM_H */
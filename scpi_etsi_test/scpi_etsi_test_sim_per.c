@@ -0,0 +1,152 @@
+/**
+@file
+@license   $License$
+@copyright $Copyright$
+@version   $Revision$
+@purpose   SCPI ETSI TEST simulated radio backend
+@brief     Monte Carlo packet error engine of the simulated transceiver
+*/
+#include <stdint.h>
+#include <stddef.h>
+#include "scpi_etsi_test_sim_per.h"
+
+// AVX2 implementation is compiled with target attribute and selected at run time
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SCPI_ETSI_TEST_SIM_PER_AVX2 1
+#include <immintrin.h>
+#else
+#define SCPI_ETSI_TEST_SIM_PER_AVX2 0
+#endif
+
+// outcomes are decided on 53 random bits, so probability 0 and 1 are exact
+#define SCPI_ETSI_TEST_SIM_PER_RANDOM_SHIFT 11
+#define SCPI_ETSI_TEST_SIM_PER_RANDOM_RANGE 9007199254740992.0
+
+/**
+ *  Generates next number of splitmix64 sequence, used to expand seed into generator state.
+ *
+ *  @param[inout] x - sequence state
+ *  @return next number
+*/
+static uint64_t SCPI_ETSI_TEST_SIM_PER_SplitMix(uint64_t* x){
+	uint64_t z = (*x += 0x9E3779B97F4A7C15ull);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	return z ^ (z >> 31);
+}
+
+static inline uint64_t SCPI_ETSI_TEST_SIM_PER_Rotl(uint64_t x, int k){
+	return (x << k) | (x >> (64 - k));
+}
+
+/**
+ *  Fills outcome words using plain C, one lane after another.
+ *
+ *  @param[inout] generator - generator
+ *  @param[in] threshold - reception threshold
+ *  @param[out] bitmap - outcome bitmap
+ *  @param[in] words - number of bitmap words to fill
+*/
+static void SCPI_ETSI_TEST_SIM_PER_SampleScalar(SCPI_ETSI_TEST_SIM_PER_Generator* generator, uint64_t threshold, uint64_t* bitmap, size_t words){
+	uint64_t (*s)[SCPI_ETSI_TEST_SIM_PER_LANES] = generator->state;
+	for(size_t w = 0; w < words; w++){
+		uint64_t word = 0;
+		for(unsigned bit = 0; bit < SCPI_ETSI_TEST_SIM_PER_WORD_BITS; bit += SCPI_ETSI_TEST_SIM_PER_LANES){
+			for(unsigned lane = 0; lane < SCPI_ETSI_TEST_SIM_PER_LANES; lane++){
+				const uint64_t result = SCPI_ETSI_TEST_SIM_PER_Rotl(s[1][lane] * 5, 7) * 9;
+				const uint64_t t = s[1][lane] << 17;
+				s[2][lane] ^= s[0][lane];
+				s[3][lane] ^= s[1][lane];
+				s[1][lane] ^= s[2][lane];
+				s[0][lane] ^= s[3][lane];
+				s[2][lane] ^= t;
+				s[3][lane] = SCPI_ETSI_TEST_SIM_PER_Rotl(s[3][lane], 45);
+				word |= (uint64_t)((result >> SCPI_ETSI_TEST_SIM_PER_RANDOM_SHIFT) < threshold) << (bit + lane);
+			}
+		}
+		bitmap[w] = word;
+	}
+}
+
+#if SCPI_ETSI_TEST_SIM_PER_AVX2
+// rotates 64-bit lanes left, k must be a constant
+#define SCPI_ETSI_TEST_SIM_PER_ROTL256(x, k) _mm256_or_si256(_mm256_slli_epi64((x), (k)), _mm256_srli_epi64((x), 64 - (k)))
+
+/**
+ *  Fills outcome words using AVX2, all lanes at once. Produces the same bits as
+ *  SCPI_ETSI_TEST_SIM_PER_SampleScalar.
+ *
+ *  @param[inout] generator - generator
+ *  @param[in] threshold - reception threshold
+ *  @param[out] bitmap - outcome bitmap
+ *  @param[in] words - number of bitmap words to fill
+*/
+__attribute__((target("avx2"))) static void SCPI_ETSI_TEST_SIM_PER_SampleAVX2(SCPI_ETSI_TEST_SIM_PER_Generator* generator, uint64_t threshold, uint64_t* bitmap, size_t words){
+	__m256i s0 = _mm256_loadu_si256((const __m256i*)generator->state[0]);
+	__m256i s1 = _mm256_loadu_si256((const __m256i*)generator->state[1]);
+	__m256i s2 = _mm256_loadu_si256((const __m256i*)generator->state[2]);
+	__m256i s3 = _mm256_loadu_si256((const __m256i*)generator->state[3]);
+	// both sides of the comparison are below 2^63, so signed comparison is sufficient
+	const __m256i limit = _mm256_set1_epi64x((long long)threshold);
+	for(size_t w = 0; w < words; w++){
+		uint64_t word = 0;
+		for(unsigned bit = 0; bit < SCPI_ETSI_TEST_SIM_PER_WORD_BITS; bit += SCPI_ETSI_TEST_SIM_PER_LANES){
+			// x * 5 and x * 9 as shift and add, AVX2 has no 64-bit multiply
+			const __m256i times5 = _mm256_add_epi64(_mm256_slli_epi64(s1, 2), s1);
+			const __m256i rotated = SCPI_ETSI_TEST_SIM_PER_ROTL256(times5, 7);
+			const __m256i result = _mm256_add_epi64(_mm256_slli_epi64(rotated, 3), rotated);
+			const __m256i t = _mm256_slli_epi64(s1, 17);
+			s2 = _mm256_xor_si256(s2, s0);
+			s3 = _mm256_xor_si256(s3, s1);
+			s1 = _mm256_xor_si256(s1, s2);
+			s0 = _mm256_xor_si256(s0, s3);
+			s2 = _mm256_xor_si256(s2, t);
+			s3 = SCPI_ETSI_TEST_SIM_PER_ROTL256(s3, 45);
+			const __m256i received = _mm256_cmpgt_epi64(limit, _mm256_srli_epi64(result, SCPI_ETSI_TEST_SIM_PER_RANDOM_SHIFT));
+			word |= (uint64_t)_mm256_movemask_pd(_mm256_castsi256_pd(received)) << bit;
+		}
+		bitmap[w] = word;
+	}
+	_mm256_storeu_si256((__m256i*)generator->state[0], s0);
+	_mm256_storeu_si256((__m256i*)generator->state[1], s1);
+	_mm256_storeu_si256((__m256i*)generator->state[2], s2);
+	_mm256_storeu_si256((__m256i*)generator->state[3], s3);
+}
+#endif
+
+void SCPI_ETSI_TEST_SIM_PER_Seed(SCPI_ETSI_TEST_SIM_PER_Generator* generator, uint64_t seed, uint64_t stream){
+	uint64_t x = seed ^ (stream * 0xD1B54A32D192ED03ull);
+	for(unsigned lane = 0; lane < SCPI_ETSI_TEST_SIM_PER_LANES; lane++){
+		for(unsigned i = 0; i < 4; i++){
+			generator->state[i][lane] = SCPI_ETSI_TEST_SIM_PER_SplitMix(&x);
+		}
+	}
+}
+
+uint64_t SCPI_ETSI_TEST_SIM_PER_Threshold(double probability){
+	if(!(probability > 0.0)){
+		return (uint64_t)SCPI_ETSI_TEST_SIM_PER_RANDOM_RANGE;
+	}
+	if(probability >= 1.0){
+		return 0;
+	}
+	return (uint64_t)((1.0 - probability) * SCPI_ETSI_TEST_SIM_PER_RANDOM_RANGE);
+}
+
+void SCPI_ETSI_TEST_SIM_PER_Sample(SCPI_ETSI_TEST_SIM_PER_Generator* generator, uint64_t threshold, uint64_t* bitmap, size_t words){
+#if SCPI_ETSI_TEST_SIM_PER_AVX2
+	if(__builtin_cpu_supports("avx2")){
+		SCPI_ETSI_TEST_SIM_PER_SampleAVX2(generator, threshold, bitmap, words);
+		return;
+	}
+#endif
+	SCPI_ETSI_TEST_SIM_PER_SampleScalar(generator, threshold, bitmap, words);
+}
+
+uint64_t SCPI_ETSI_TEST_SIM_PER_Count(const uint64_t* bitmap, size_t words){
+	uint64_t count = 0;
+	for(size_t w = 0; w < words; w++){
+		count += SCPI_ETSI_TEST_SIM_PER_Popcount(bitmap[w]);
+	}
+	return count;
+}
@@ -0,0 +1,83 @@
+/**
+@file
+@license   $License$
+@copyright $Copyright$
+@version   $Revision$
+@purpose   SCPI ETSI TEST simulated radio backend
+@brief     Monte Carlo packet error engine of the simulated transceiver
+*/
+
+#ifndef SCPI_ETSI_TEST_SIM_PER_H
+#define SCPI_ETSI_TEST_SIM_PER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+enum {
+	// number of interleaved xoshiro256** generators
+	SCPI_ETSI_TEST_SIM_PER_LANES = 4,
+	// number of packets decided by one outcome word
+	SCPI_ETSI_TEST_SIM_PER_WORD_BITS = 64,
+};
+
+/** packet outcome generator (xoshiro256** lanes, state stored word-major) */
+typedef struct{
+	uint64_t state[4][SCPI_ETSI_TEST_SIM_PER_LANES];
+}SCPI_ETSI_TEST_SIM_PER_Generator;
+
+/**
+ *  Seeds the generator. The same seed and stream always produce the same outcomes,
+ *  regardless of whether the vectorized or the scalar implementation is used.
+ *
+ *  @param[out] generator - generator to seed
+ *  @param[in] seed - user seed
+ *  @param[in] stream - stream number (e.g. PER test ID) selecting independent sequence
+*/
+void SCPI_ETSI_TEST_SIM_PER_Seed(SCPI_ETSI_TEST_SIM_PER_Generator* generator, uint64_t seed, uint64_t stream);
+
+/**
+ *  Converts packet error probability to the threshold used by SCPI_ETSI_TEST_SIM_PER_Sample.
+ *
+ *  @param[in] probability - packet error probability (0 to 1)
+ *  @return reception threshold
+*/
+uint64_t SCPI_ETSI_TEST_SIM_PER_Threshold(double probability);
+
+/**
+ *  Decides outcomes of words * 64 packets. Bit n of the bitmap is set when n-th packet
+ *  is received.
+ *
+ *  @param[inout] generator - generator
+ *  @param[in] threshold - reception threshold from SCPI_ETSI_TEST_SIM_PER_Threshold
+ *  @param[out] bitmap - outcome bitmap
+ *  @param[in] words - number of bitmap words to fill
+*/
+void SCPI_ETSI_TEST_SIM_PER_Sample(SCPI_ETSI_TEST_SIM_PER_Generator* generator, uint64_t threshold, uint64_t* bitmap, size_t words);
+
+/**
+ *  Counts bits set in the bitmap.
+ *
+ *  @param[in] bitmap - outcome bitmap
+ *  @param[in] words - number of bitmap words
+ *  @return number of received packets
+*/
+uint64_t SCPI_ETSI_TEST_SIM_PER_Count(const uint64_t* bitmap, size_t words);
+
+/**
+ *  Counts bits set in one bitmap word.
+ *
+ *  @param[in] word - outcome word
+ *  @return number of bits set
+*/
+static inline uint32_t SCPI_ETSI_TEST_SIM_PER_Popcount(uint64_t word){
+#if defined(__GNUC__)
+	return (uint32_t)__builtin_popcountll(word);
+#else
+	word = word - ((word >> 1) & 0x5555555555555555ull);
+	word = (word & 0x3333333333333333ull) + ((word >> 2) & 0x3333333333333333ull);
+	word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+	return (uint32_t)((word * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+#endif /* SCPI_ETSI_TEST_SIM_PER_H */
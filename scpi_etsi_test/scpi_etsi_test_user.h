@@ -61,28 +61,83 @@ bool SCPI_ETSI_TEST_USER_SetTRXMode(SCPI_ETSI_TEST_DeviceDescriptor* deviceDescr
  * THIS FUNCTION IS IMPLEMENTED BY THE USER.
  *
  * Starts Packet Error Rate (PER) test. This command is issued to the device being the source of packets in a PER test.
+ * Every PHY and antenna pair has its own PER test slot (numbered by PHY, then by antenna, antennaCount + 1 slots
+ * per PHY), tests of different slots may run at the same time. When the test finishes, the implementation should call
+ * SCPI_ETSI_TEST_PERTestFinished with its slot.
  * @param[inout] deviceDescriptor pointer to the device descriptor structure
+ * @param[in] slot PER test slot of the selected PHY and antenna
  * @param[in] testID identification number of PER test
  * @return true on success, false otherwise
  */
-bool SCPI_ETSI_TEST_USER_StartPERTest(SCPI_ETSI_TEST_DeviceDescriptor* deviceDescriptor, uint32_t testID);
+bool SCPI_ETSI_TEST_USER_StartPERTest(SCPI_ETSI_TEST_DeviceDescriptor* deviceDescriptor, uint16_t slot, uint32_t testID);
 
 /**
  * THIS FUNCTION IS IMPLEMENTED BY THE USER.
  *
- * Checks if there is an ongoing PER test.
+ * Checks if there is an ongoing PER test in given slot.
  * @param[inout] deviceDescriptor pointer to the device descriptor structure
- * @return true when some PER test is running, false otherwise
+ * @param[in] slot PER test slot
+ * @return true when PER test is running in the slot, false otherwise
  */
-bool SCPI_ETSI_TEST_USER_IsPERTestRunning(SCPI_ETSI_TEST_DeviceDescriptor* deviceDescriptor);
+bool SCPI_ETSI_TEST_USER_IsPERTestRunning(SCPI_ETSI_TEST_DeviceDescriptor* deviceDescriptor, uint16_t slot);
 
 /**
  * THIS FUNCTION IS IMPLEMENTED BY THE USER.
  *
- * Gets the result of a PER test.
+ * Gets the result of a PER test of given slot.
  * @param[inout] deviceDescriptor pointer to the device descriptor structure
+ * @param[in] slot PER test slot
  * @return address of structure storing information about PER test result
  */
-SCPI_ETSI_TEST_PERTestResult* SCPI_ETSI_TEST_USER_GetPERTestResult(SCPI_ETSI_TEST_DeviceDescriptor* deviceDescriptor);
+SCPI_ETSI_TEST_PERTestResult* SCPI_ETSI_TEST_USER_GetPERTestResult(SCPI_ETSI_TEST_DeviceDescriptor* deviceDescriptor, uint16_t slot);
+
+/**
+ * THIS FUNCTION IS IMPLEMENTED BY THE USER.
+ *
+ * Gets progress of the running or last PER test of given slot. It is polled frequently, so it should
+ * only copy counters maintained by the radio.
+ * @param[inout] deviceDescriptor pointer to the device descriptor structure
+ * @param[in] slot PER test slot
+ * @param[out] progress PER test progress
+ * @return true on success, false otherwise
+ */
+bool SCPI_ETSI_TEST_USER_GetPERTestProgress(SCPI_ETSI_TEST_DeviceDescriptor* deviceDescriptor, uint16_t slot, SCPI_ETSI_TEST_PERTestProgress* progress);
+
+/**
+ * THIS FUNCTION IS IMPLEMENTED BY THE USER.
+ *
+ * Gets free running millisecond counter, used to time periodic reports.
+ * @return time in ms
+ */
+uint32_t SCPI_ETSI_TEST_USER_GetTime(void);
+
+/**
+ * THIS FUNCTION IS IMPLEMENTED BY THE USER.
+ *
+ * Waits for an event, e.g. by sleeping until an interrupt. Returns after given time or earlier,
+ * at the latest when SCPI_ETSI_TEST_PERTestFinished is called. Returning early without reason
+ * is allowed, but then the caller keeps polling PER test status.
+ * @param[in] timeout maximal waiting time in ms
+ */
+void SCPI_ETSI_TEST_USER_WaitForEvent(uint32_t timeout);
+
+/**
+ * THIS FUNCTION MAY BE IMPLEMENTED BY THE USER. With GCC a weak default returning false is provided,
+ * other compilers need a user implementation.
+ *
+ * Runs PER tests for a batch of the grid of every transmit power (lowestPower..highestPower, step 1 dBm)
+ * and every channel of the selected PHY, using the remaining phySettings. Points of the grid are ordered
+ * by channel, then by power; point n uses test ID testID + n. Large grids are run in several batches.
+ * A device which cannot do better than sequential PER tests returns false and the batch is run through
+ * the PER test functions above.
+ * @param[inout] deviceDescriptor pointer to the device descriptor structure
+ * @param[in] testID identification number of the PER test of grid point 0
+ * @param[in] firstPoint index of the first grid point of the batch
+ * @param[in] pointCount number of grid points of the batch
+ * @param[out] results array of pointCount PER test results, results[i] belongs to point firstPoint + i
+ * @return true when the batch has been run, false otherwise
+ */
+bool SCPI_ETSI_TEST_USER_RunPERSweep(SCPI_ETSI_TEST_DeviceDescriptor* deviceDescriptor, uint32_t testID, size_t firstPoint,
+		size_t pointCount, SCPI_ETSI_TEST_PERTestResult* results);
 
 #endif /* SCPI_ETSI_TEST_USER_H */
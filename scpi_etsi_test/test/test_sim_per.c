@@ -0,0 +1,162 @@
+/**
+@file
+@license   $License$
+@copyright $Copyright$
+@version   $Revision$
+@purpose   SCPI ETSI TEST simulated radio backend
+@brief     Tests of the Monte Carlo packet error engine of the simulated transceiver
+*/
+// sources are included to reach their static functions, simulator sets POSIX feature macros first
+#include "scpi_etsi_test_sim.c"
+#include "scpi_etsi_test_sim_per.c"
+
+enum {
+	// number of outcome words compared by every test
+	TEST_WORDS = 200,
+};
+
+// seeds and packet error probabilities every test is run with
+static const uint64_t testSeeds[] = { 0, 1, 0x0123456789ABCDEFull };
+static const double testProbabilities[] = { 0.0, 0.001, 0.3, 0.5, 0.999, 1.0 };
+
+static unsigned testCount;
+static unsigned failCount;
+
+// counts check, reports failed one with its line
+#define TEST_CHECK(condition) do{ \
+		testCount++; \
+		if(!(condition)){ \
+			failCount++; \
+			printf("%s:%d: %s\n", __FILE__, __LINE__, #condition); \
+		} \
+	} while(0)
+
+/**
+ *  Stub of the ETSI layer, simulated PER tests are not run here.
+*/
+SCPI_ETSI_TEST_PERVerdict SCPI_ETSI_TEST_GetPERVerdict(const SCPI_ETSI_TEST_PhySettings* settings, uint32_t sentPackets,
+		uint32_t receivedPackets, uint32_t* lower, uint32_t* upper){
+	(void)settings;
+	(void)sentPackets;
+	(void)receivedPackets;
+	(void)lower;
+	(void)upper;
+	return SCPI_ETSI_TEST_PER_UNDECIDED;
+}
+
+/**
+ *  Stub of the ETSI layer, simulated PER tests are not run here.
+*/
+void SCPI_ETSI_TEST_PERTestFinished(uint16_t slot){
+	(void)slot;
+}
+
+/**
+ *  Checks that the AVX2 implementation gives the same outcomes and generator state as the scalar one.
+*/
+static void TestSampleAVX2(void){
+#if SCPI_ETSI_TEST_SIM_PER_AVX2
+	if(!__builtin_cpu_supports("avx2")){
+		printf("SampleAVX2: skipped, CPU without AVX2\n");
+		return;
+	}
+	for(size_t s = 0; s < sizeof(testSeeds)/sizeof(testSeeds[0]); s++){
+		for(size_t p = 0; p < sizeof(testProbabilities)/sizeof(testProbabilities[0]); p++){
+			const uint64_t threshold = SCPI_ETSI_TEST_SIM_PER_Threshold(testProbabilities[p]);
+			SCPI_ETSI_TEST_SIM_PER_Generator scalar;
+			SCPI_ETSI_TEST_SIM_PER_Generator avx2;
+			uint64_t scalarBitmap[TEST_WORDS];
+			uint64_t avx2Bitmap[TEST_WORDS];
+			SCPI_ETSI_TEST_SIM_PER_Seed(&scalar, testSeeds[s], 7);
+			SCPI_ETSI_TEST_SIM_PER_Seed(&avx2, testSeeds[s], 7);
+			SCPI_ETSI_TEST_SIM_PER_SampleScalar(&scalar, threshold, scalarBitmap, TEST_WORDS);
+			SCPI_ETSI_TEST_SIM_PER_SampleAVX2(&avx2, threshold, avx2Bitmap, TEST_WORDS);
+			TEST_CHECK(0 == memcmp(scalarBitmap, avx2Bitmap, sizeof(scalarBitmap)));
+			TEST_CHECK(0 == memcmp(&scalar, &avx2, sizeof(scalar)));
+		}
+	}
+#else
+	printf("SampleAVX2: skipped, not compiled for x86\n");
+#endif
+}
+
+/**
+ *  Checks probability 0 and 1 are exact.
+*/
+static void TestThreshold(void){
+	SCPI_ETSI_TEST_SIM_PER_Generator generator;
+	uint64_t bitmap[TEST_WORDS];
+	SCPI_ETSI_TEST_SIM_PER_Seed(&generator, 1, 1);
+	SCPI_ETSI_TEST_SIM_PER_Sample(&generator, SCPI_ETSI_TEST_SIM_PER_Threshold(0.0), bitmap, TEST_WORDS);
+	TEST_CHECK(SCPI_ETSI_TEST_SIM_PER_Count(bitmap, TEST_WORDS) == (uint64_t)TEST_WORDS * SCPI_ETSI_TEST_SIM_PER_WORD_BITS);
+	SCPI_ETSI_TEST_SIM_PER_Sample(&generator, SCPI_ETSI_TEST_SIM_PER_Threshold(1.0), bitmap, TEST_WORDS);
+	TEST_CHECK(SCPI_ETSI_TEST_SIM_PER_Count(bitmap, TEST_WORDS) == 0);
+}
+
+/**
+ *  Checks that outcome words do not depend on how they are split between Sample calls.
+*/
+static void TestSampleSplit(void){
+	for(size_t s = 0; s < sizeof(testSeeds)/sizeof(testSeeds[0]); s++){
+		const uint64_t threshold = SCPI_ETSI_TEST_SIM_PER_Threshold(0.3);
+		SCPI_ETSI_TEST_SIM_PER_Generator whole;
+		SCPI_ETSI_TEST_SIM_PER_Generator split;
+		uint64_t wholeBitmap[TEST_WORDS];
+		uint64_t splitBitmap[TEST_WORDS];
+		SCPI_ETSI_TEST_SIM_PER_Seed(&whole, testSeeds[s], 3);
+		SCPI_ETSI_TEST_SIM_PER_Seed(&split, testSeeds[s], 3);
+		SCPI_ETSI_TEST_SIM_PER_Sample(&whole, threshold, wholeBitmap, TEST_WORDS);
+		for(size_t w = 0, words = 1; w < TEST_WORDS; w += words, words = words % 7 + 1){
+			if(words > TEST_WORDS - w){
+				words = TEST_WORDS - w;
+			}
+			SCPI_ETSI_TEST_SIM_PER_Sample(&split, threshold, &splitBitmap[w], words);
+		}
+		TEST_CHECK(0 == memcmp(wholeBitmap, splitBitmap, sizeof(wholeBitmap)));
+	}
+}
+
+/**
+ *  Checks that packets received by the simulator do not depend on how they are split between
+ *  polls: after every poll the count equals received packets of the same prefix of one outcome stream.
+*/
+static void TestReceiveSplit(void){
+	static const uint32_t polls[] = { 1, 63, 64, 65, 127, 3, 200, 4096, 5, 64 * SCPI_ETSI_TEST_SIM_BATCH_WORDS + 17, 0, 2 };
+	uint32_t total = 0;
+	for(size_t i = 0; i < sizeof(polls)/sizeof(polls[0]); i++){
+		total += polls[i];
+	}
+	for(size_t s = 0; s < sizeof(testSeeds)/sizeof(testSeeds[0]); s++){
+		for(size_t p = 0; p < sizeof(testProbabilities)/sizeof(testProbabilities[0]); p++){
+			const size_t words = (total + SCPI_ETSI_TEST_SIM_PER_WORD_BITS - 1) / SCPI_ETSI_TEST_SIM_PER_WORD_BITS;
+			uint64_t reference[words];
+			SCPI_ETSI_TEST_SIM_PER_Generator generator;
+			SCPI_ETSI_TEST_SIM_PacketStream stream = { .threshold = SCPI_ETSI_TEST_SIM_PER_Threshold(testProbabilities[p]) };
+			SCPI_ETSI_TEST_SIM_PER_Seed(&generator, testSeeds[s], 11);
+			SCPI_ETSI_TEST_SIM_PER_Sample(&generator, stream.threshold, reference, words);
+			SCPI_ETSI_TEST_SIM_PER_Seed(&stream.generator, testSeeds[s], 11);
+			uint32_t sent = 0;
+			uint32_t received = 0;
+			uint32_t expected = 0;
+			bool equal = true;
+			for(size_t i = 0; i < sizeof(polls)/sizeof(polls[0]); i++){
+				received += SCPI_ETSI_TEST_SIM_Receive(&stream, polls[i]);
+				for(uint32_t n = sent; n < sent + polls[i]; n++){
+					expected += (uint32_t)((reference[n / SCPI_ETSI_TEST_SIM_PER_WORD_BITS] >> (n % SCPI_ETSI_TEST_SIM_PER_WORD_BITS)) & 1);
+				}
+				sent += polls[i];
+				equal = equal && (received == expected);
+			}
+			TEST_CHECK(equal);
+		}
+	}
+}
+
+int main(void){
+	TestSampleAVX2();
+	TestThreshold();
+	TestSampleSplit();
+	TestReceiveSplit();
+	printf("test_sim_per: %u checks, %u failed\n", testCount, failCount);
+	return (0 == failCount) ? 0 : 1;
+}